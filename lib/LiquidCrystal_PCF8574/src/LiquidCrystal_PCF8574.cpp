@@ -37,6 +37,7 @@ void LiquidCrystal_PCF8574::init(uint8_t i2cAddr, uint8_t rs, uint8_t rw, uint8_
 
   _entrymode = 0x02; // like Initializing by Internal Reset Circuit
   _displaycontrol = 0x04;
+  _settleBytes = 0; // enough for up to 400 kHz, see setBusClock()
 
   _rs_mask = 0x01 << rs;
   if (rw != 255)
@@ -281,6 +282,44 @@ inline size_t LiquidCrystal_PCF8574::write(uint8_t ch)
 } // write()
 
 
+/// Write several characters with as few I2C transmissions as possible.
+/// Every character still costs 4 bytes on the PCF8574 (two nibbles with enable pulse),
+/// but the address phase and start/stop conditions are shared by all characters
+/// that fit into the Wire buffer.
+size_t LiquidCrystal_PCF8574::writeBuffer(const uint8_t *buffer, size_t size)
+{
+  const size_t chunk = charsPerTransmission();
+  size_t done = 0;
+
+  while (done < size) {
+    size_t count = min(size - done, chunk);
+    _i2cPort->beginTransmission(_i2cAddr);
+    for (size_t i = 0; i < count; i++) {
+      uint8_t value = buffer[done + i];
+      _writeNibble((value >> 4 & 0x0F), true);
+      _writeNibble((value & 0x0F), true);
+      // The character is latched with the falling enable of the low nibble. The next one
+      // is latched two bytes later; at higher clocks add idle bytes to cover the 37+4us
+      // the HD44780 needs to execute a data write.
+      for (uint8_t s = 0; s < _settleBytes; s++)
+        _i2cPort->write(_nibbleData((value & 0x0F), true));
+    }
+    _i2cPort->endTransmission();
+    done += count;
+  }
+  return size;
+} // writeBuffer()
+
+
+/// Compute the idle bytes writeBuffer() needs between characters at the given I2C clock.
+void LiquidCrystal_PCF8574::setBusClock(uint32_t clockHz)
+{
+  // 2 bytes of 9 clock ticks pass between two latches, the HD44780 needs 41us.
+  uint32_t needed = (41UL * (clockHz / 1000UL) + 999UL) / 1000UL; // clock ticks, rounded up
+  _settleBytes = (needed > 18) ? (needed - 18 + 8) / 9 : 0;
+} // setBusClock()
+
+
 // write either command or data
 void LiquidCrystal_PCF8574::_send(uint8_t value, bool isData)
 {
@@ -299,17 +338,7 @@ void LiquidCrystal_PCF8574::_send(uint8_t value, bool isData)
 // write a nibble / halfByte with handshake
 void LiquidCrystal_PCF8574::_writeNibble(uint8_t halfByte, bool isData)
 {
-  // map the data to the given pin connections
-  uint8_t data = isData ? _rs_mask : 0;
-  // _rw_mask is not used here.
-  if (_backlight > 0)
-    data |= _backlight_mask;
-
-  // allow for arbitrary pin configuration
-  if (halfByte & 0x01) data |= _data_mask[0];
-  if (halfByte & 0x02) data |= _data_mask[1];
-  if (halfByte & 0x04) data |= _data_mask[2];
-  if (halfByte & 0x08) data |= _data_mask[3];
+  uint8_t data = _nibbleData(halfByte, isData);
 
   // Note that the specified speed of the PCF8574 chip is 100KHz.
   // Transmitting a single byte takes 9 clock ticks at 100kHz -> 90us.
@@ -326,6 +355,24 @@ void LiquidCrystal_PCF8574::_writeNibble(uint8_t halfByte, bool isData)
 } // _writeNibble
 
 
+// map a nibble / halfByte to the PCF8574 pins, enable not set
+uint8_t LiquidCrystal_PCF8574::_nibbleData(uint8_t halfByte, bool isData)
+{
+  // map the data to the given pin connections
+  uint8_t data = isData ? _rs_mask : 0;
+  // _rw_mask is not used here.
+  if (_backlight > 0)
+    data |= _backlight_mask;
+
+  // allow for arbitrary pin configuration
+  if (halfByte & 0x01) data |= _data_mask[0];
+  if (halfByte & 0x02) data |= _data_mask[1];
+  if (halfByte & 0x04) data |= _data_mask[2];
+  if (halfByte & 0x08) data |= _data_mask[3];
+  return data;
+} // _nibbleData
+
+
 // write a nibble / halfByte with handshake
 void LiquidCrystal_PCF8574::_sendNibble(uint8_t halfByte, bool isData)
 {
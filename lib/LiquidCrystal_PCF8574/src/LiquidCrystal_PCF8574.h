@@ -22,6 +22,7 @@
 /// * 26.05.2022 8-bit datatypes in interfaces and compatibility topics.
 /// * 26.05.2022 createChar with PROGMEM character data for AVR processors.
 /// * 26.05.2022 constructor with pin assignments. Thanks to @markisch.
+/// * writeBuffer() streaming several characters per I2C transmission.
 
 #ifndef LiquidCrystal_PCF8574_h
 #define LiquidCrystal_PCF8574_h
@@ -32,6 +33,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Size of the Wire transmit buffer, limits the characters packed into one transmission by writeBuffer().
+#if defined(I2C_BUFFER_LENGTH)
+#define LCD_PCF8574_WIRE_BUFFER I2C_BUFFER_LENGTH
+#elif defined(BUFFER_LENGTH)
+#define LCD_PCF8574_WIRE_BUFFER BUFFER_LENGTH
+#else
+#define LCD_PCF8574_WIRE_BUFFER 32
+#endif
+
 
 class LiquidCrystal_PCF8574 : public Print
 {
@@ -100,6 +110,14 @@ public:
   // support of Print class
   virtual size_t write(uint8_t ch);
 
+  // Send several characters packed into as few I2C transmissions as the Wire buffer allows.
+  size_t writeBuffer(const uint8_t *buffer, size_t size);
+  // Tell the library the I2C clock in use, so writeBuffer() can keep the HD44780 execution time
+  // between characters. Default assumes up to 400 kHz.
+  void setBusClock(uint32_t clockHz);
+  // Number of characters writeBuffer() sends in a single transmission.
+  inline uint8_t charsPerTransmission() const { return LCD_PCF8574_WIRE_BUFFER / (4 + _settleBytes); }
+
 private:
 
   TwoWire *_i2cPort; //The generic connection to user's chosen I2C hardware
@@ -112,6 +130,7 @@ private:
   uint8_t _entrymode; ///<flags from entrymode
   uint8_t _displaycontrol; ///<flags from displaycontrol
   uint8_t _row_offsets[4];
+  uint8_t _settleBytes; ///< idle bytes after each character in writeBuffer()
 
   // variables describing how the PCF8574 is connected to the LCD
   uint8_t _rs_mask;
@@ -125,6 +144,7 @@ private:
   void _send(uint8_t value, bool isData = false);
   void _sendNibble(uint8_t halfByte, bool isData = false);
   void _writeNibble(uint8_t halfByte, bool isData);
+  uint8_t _nibbleData(uint8_t halfByte, bool isData);
   void _write2Wire(uint8_t data, bool isData, bool enable);
 
   void init(uint8_t i2cAddr, uint8_t rs, uint8_t rw, uint8_t enable,
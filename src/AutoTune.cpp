@@ -8,12 +8,14 @@
 #include "Globals.h"
 #include "Config.h"
 #include "Utils.h"
+#include "ChannelState.h"
+#include "Persistence.h"
 
 void autoTunePID() {
     const unsigned long tuningDuration = 30000; // 30 секунд
     unsigned long startTime = millis();
     unsigned long lastPeakTime = startTime;
-    double peakTemp = channels[0]->getTemperature();
+    double peakTemp = readSystemState().channels[0].temperature;
     int oscillationCount = 0;
     double output = 50.0; // Начальное значение мощности
 
@@ -21,7 +23,7 @@ void autoTunePID() {
     channels[0]->controlHeater(static_cast<int>(output * PWM_MAX_DUTY / 100));
 
     while (millis() - startTime < tuningDuration) {
-        double currentTemp = channels[0]->getTemperature();
+        double currentTemp = readSystemState().channels[0].temperature;
         if (currentTemp > peakTemp + 1.0) {
             unsigned long now = millis();
             double currentTu = (now - lastPeakTime) / 1000.0; // Период в секундах
@@ -42,10 +44,10 @@ void autoTunePID() {
     double newKd = Ku * Tu / 8.0;
     for (int i = 0; i < NUM_CHANNELS; i++) {
         if (channels[i]) {
-            channels[i]->getPID().Kp = newKp;
-            channels[i]->getPID().Ki = newKi;
-            channels[i]->getPID().Kd = newKd;
+            channels[i]->getPID().setTunings(newKp, newKi, newKd);
         }
     }
     Serial.printf("[AUTOTUNE] Завершено. Kp=%.2f, Ki=%.2f, Kd=%.2f\n", newKp, newKi, newKd);
+    // Новые коэффициенты входят в сохраняемую конфигурацию
+    notifyPersistence(PERSIST_EVENT_DIRTY);
 }
@@ -2,25 +2,36 @@
 #ifndef BASE_CHANNEL_H
 #define BASE_CHANNEL_H
 
-#include <GyverPID.h>
+#include "PIDBank.h"
+#include "TemperatureFilter.h"
 
 // Абстрактный базовый класс для каналов управления нагревателями.
 // Все конкретные реализации (например, HeaterChannel) должны реализовывать данные методы.
+// Сам расчёт PID выполняется пакетно для всех каналов в PIDBank (задача управления).
 class BaseChannel {
 public:
     virtual ~BaseChannel() = default;
     virtual void emergencyStop() = 0;
     virtual void readAndUpdateTemperature() = 0;
-    virtual void updatePID() = 0;
     virtual void controlHeater(int value) = 0;
     virtual void processEncoder(unsigned long currentMillis, bool &changedFlag) = 0;
     virtual void updateDisplay() = 0;
     
-    virtual GyverPID& getPID() = 0;
-    virtual double getSetpoint() const = 0;
-    virtual void setSetpoint(double sp) = 0;
-    virtual double getTemperature() const = 0;
+    virtual PIDBank::Channel& getPID() = 0;
+    virtual TemperatureFilter& getFilter() = 0;
+    virtual float getSetpoint() const = 0;
+    virtual void setSetpoint(float sp) = 0;
+    // Пределы уставки канала (внутри аппаратных пределов строки CHANNEL_TABLE).
+    virtual float getMinSetpoint() const = 0;
+    virtual float getMaxSetpoint() const = 0;
+    virtual void setSetpointLimits(float minSp, float maxSp) = 0;
+    virtual float getTemperature() const = 0;
+    // Калибровочное смещение, прибавляемое к температуре датчика.
+    virtual float getCalibrationOffset() const = 0;
+    virtual void setCalibrationOffset(float offset) = 0;
     virtual int getOutput() = 0;
+    // Скважность, последней поданная на нагреватель через controlHeater().
+    virtual int getDuty() const = 0;
 };
 
 #endif
@@ -0,0 +1,25 @@
+// ChannelState.cpp
+// Снимок состояния каналов, публикуемый задачей управления для читателей без блокировок.
+#include <Arduino.h>
+#include <string.h>
+#include <freertos/task.h>
+#include "ChannelState.h"
+
+SeqLock<SystemSnapshot> systemState;
+
+SystemSnapshot readSystemState() {
+    SystemSnapshot snap;
+    if (!systemState.read(snap)) {
+        memset(&snap, 0, sizeof(snap));
+        snap.mode = STANDBY_MODE;
+    }
+    return snap;
+}
+
+void waitNextPublish(TickType_t timeout) {
+    uint32_t version = systemState.version();
+    TickType_t start = xTaskGetTickCount();
+    while (systemState.version() == version && xTaskGetTickCount() - start < timeout) {
+        vTaskDelay(1);
+    }
+}
@@ -0,0 +1,79 @@
+// ChannelState.h
+#ifndef CHANNEL_STATE_H
+#define CHANNEL_STATE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "Globals.h"
+
+// Флаги состояния канала в снимке
+#define CHANNEL_FLAG_SENSOR_FAULT 0x01  // Последний отсчёт датчика неисправен
+#define CHANNEL_FLAG_HEATING      0x02  // На нагреватель подана ненулевая мощность
+#define CHANNEL_FLAG_REACHED      0x04  // Температура в полосе ±0.5 °C от уставки
+
+// Состояние одного канала на конец цикла задачи управления.
+struct ChannelState {
+    float temperature;  // °C после фильтра и калибровки (NaN - датчик неисправен)
+    float setpoint;     // Уставка, °C
+    int16_t output;     // Скважность, фактически поданная на нагреватель (0..PWM_MAX_DUTY)
+    uint8_t flags;      // CHANNEL_FLAG_*
+};
+
+// Снимок всей системы, публикуемый задачей управления раз в цикл.
+struct SystemSnapshot {
+    ChannelState channels[NUM_CHANNELS];
+    SystemMode mode;
+    uint32_t cycle;     // Номер цикла задачи управления
+    TickType_t tick;    // Тик публикации
+};
+
+// Последовательная блокировка (seqlock) для одного писателя и любого числа читателей.
+// Писатель не ждёт никогда; читатель копирует данные и повторяет копирование,
+// если за это время счётчик изменился. Ни мьютексов, ни инверсии приоритетов.
+template <typename T>
+class SeqLock {
+public:
+    // Публикация нового значения (только из задачи-писателя).
+    void write(const T& value) {
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);  // Нечётный - идёт запись
+        std::atomic_thread_fence(std::memory_order_release);
+        data = value;
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // Согласованная копия последнего опубликованного значения.
+    // false - публикаций ещё не было (out не изменяется).
+    bool read(T& out) const {
+        for (;;) {
+            uint32_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 == 0) return false;
+            if (s1 & 1) continue;  // Писатель в середине записи
+            out = data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1) return true;
+        }
+    }
+
+    // Число публикаций (для читателей, которым важно, изменилось ли значение).
+    uint32_t version() const { return seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+    T data;
+    std::atomic<uint32_t> seq{0};
+};
+
+// Снимок состояния каналов: пишет TaskControlHeaters, читают дисплей, энкодеры и журналы.
+extern SeqLock<SystemSnapshot> systemState;
+
+// Чтение снимка; до первой публикации возвращает нулевой снимок в режиме STANDBY.
+SystemSnapshot readSystemState();
+
+// Ожидание следующей публикации снимка, но не дольше timeout. Стирание и запись флеш на время
+// операции отключают кэш обоих ядер, и задача управления, исполняемая из флеш, стоит; операция,
+// начатая сразу после публикации, приходится на её простой до следующего периода, а не на цикл.
+void waitNextPublish(TickType_t timeout);
+
+#endif
@@ -0,0 +1,144 @@
+// ChannelTable.h
+#ifndef CHANNEL_TABLE_H
+#define CHANNEL_TABLE_H
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include <soc/soc_caps.h>
+#include "Config.h"
+
+// Число каналов LEDC в одной группе (режиме скорости) и число таймеров группы.
+#define LEDC_GROUP_CHANNELS SOC_LEDC_CHANNEL_NUM
+#define LEDC_GROUP_TIMERS SOC_LEDC_TIMER_NUM
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+#define LEDC_TOTAL_CHANNELS (2 * LEDC_GROUP_CHANNELS)
+#else
+#define LEDC_TOTAL_CHANNELS LEDC_GROUP_CHANNELS
+#endif
+
+// Описание одного канала (зоны нагрева): всё железо канала - одна строка CHANNEL_TABLE.
+// setup() проходит по таблице и по ней создаёт энкодеры, датчики, каналы и привязки к источникам.
+struct ChannelDescriptor {
+    uint8_t tcDataPin;      // DO MAX6675 (для TC_BACKEND_SPI не используется - DO объединены на TC_SPI_MISO_PIN)
+    uint8_t tcCsPin;        // CS MAX6675
+    uint8_t heaterPin;      // Выход на нагреватель
+    uint8_t pwmChannel;     // Сквозной номер канала LEDC: 0..7 - LOW_SPEED, 8..15 - HIGH_SPEED (только ESP32)
+    uint8_t pwmTimer;       // Таймер LEDC в группе канала; каналы с одной частотой могут делить таймер
+    uint8_t encDtPin;       // Энкодер: DT, CLK, SW
+    uint8_t encClkPin;
+    uint8_t encSwPin;
+    float minSetpoint;      // Допустимый диапазон уставки канала
+    float maxSetpoint;
+    float defaultSetpoint;  // Уставка, если в EEPROM нет корректного значения
+};
+
+// Таблица каналов. Чтобы добавить зону, достаточно строки здесь и увеличения NUM_CHANNELS.
+// Канал буззера (BUZZER_CHANNEL, старый API ledcSetup) в нумерации Arduino 2.x попадает
+// в группу HIGH_SPEED, т.е. соответствует pwmChannel = LEDC_GROUP_CHANNELS + BUZZER_CHANNEL - его не занимать.
+// Пины ESP32: GPIO6..11 заняты SPI-флешью модуля; 34..39 - только входы без подтяжек (годятся лишь под DO
+// с внешней подтяжкой 10 кОм к 3.3 В, 34 оставлен под POWER_WARN_PIN); 1/3 - UART0, 21/22 - I2C дисплея. Пины загрузчика: 0, 5 и 15 - кнопки
+// энкодеров (в покое подтянуты вверх, как и требуется при сбросе; нажатая при сбросе SW на GPIO0 включает
+// режим прошивки), 2 - CS (до инициализации держится внутренней подтяжкой вниз, прошивке не мешает).
+// GPIO12 не используется: высокий уровень на нём при сбросе переключает питание флеши на 1.8 В.
+constexpr ChannelDescriptor CHANNEL_TABLE[] = {
+    // DO  CS  HEAT PWM TMR  DT CLK SW   MIN           MAX           DEFAULT
+    {  35,  4,  25,  0,  0,  32, 33,  5, MIN_SETPOINT, MAX_SETPOINT, DEFAULT_SETPOINT },
+    {  36, 16,  26,  1,  1,  13, 19, 15, MIN_SETPOINT, MAX_SETPOINT, DEFAULT_SETPOINT },
+    {  39,  2,  27,  2,  2,  23, 17,  0, MIN_SETPOINT, MAX_SETPOINT, DEFAULT_SETPOINT },
+};
+
+// Канал и таймер LEDC буззера в сквозной нумерации pwmChannel. ledcSetup() Arduino 2.x кладёт канал c
+// в группу c / 8 (на ESP32 группа 0 - HIGH_SPEED) и на таймер (c / 2) % 4; частоту буззер меняет сам.
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+#define BUZZER_PWM_CHANNEL (LEDC_GROUP_CHANNELS + BUZZER_CHANNEL)
+#else
+#define BUZZER_PWM_CHANNEL BUZZER_CHANNEL
+#endif
+#define BUZZER_PWM_TIMER ((BUZZER_CHANNEL / 2) % LEDC_GROUP_TIMERS)
+
+// Канал LEDC строки i не занят строками с номера j и дальше.
+constexpr bool pwmChannelUnique(uint8_t i, uint8_t j) {
+    return j >= NUM_CHANNELS ||
+           (CHANNEL_TABLE[i].pwmChannel != CHANNEL_TABLE[j].pwmChannel && pwmChannelUnique(i, j + 1));
+}
+
+// Строка не задевает буззер: ни его канал, ни его таймер в той же группе.
+constexpr bool pwmClearOfBuzzer(uint8_t i) {
+    return CHANNEL_TABLE[i].pwmChannel != BUZZER_PWM_CHANNEL &&
+           !(CHANNEL_TABLE[i].pwmChannel / LEDC_GROUP_CHANNELS == BUZZER_PWM_CHANNEL / LEDC_GROUP_CHANNELS &&
+             CHANNEL_TABLE[i].pwmTimer == BUZZER_PWM_TIMER);
+}
+
+// Проверка строк таблицы на этапе компиляции (рекурсия - constexpr в стиле C++11).
+// Каналы LEDC у строк разные и не совпадают с каналом и таймером буззера: иначе выход одного
+// нагревателя молча переезжает на пин другого.
+constexpr bool channelTableValid(uint8_t i = 0) {
+    return i >= NUM_CHANNELS ||
+           (CHANNEL_TABLE[i].pwmChannel < LEDC_TOTAL_CHANNELS &&
+            CHANNEL_TABLE[i].pwmTimer < LEDC_GROUP_TIMERS &&
+            pwmChannelUnique(i, i + 1) &&
+            pwmClearOfBuzzer(i) &&
+            CHANNEL_TABLE[i].minSetpoint <= CHANNEL_TABLE[i].defaultSetpoint &&
+            CHANNEL_TABLE[i].defaultSetpoint <= CHANNEL_TABLE[i].maxSetpoint &&
+            channelTableValid(i + 1));
+}
+
+// Пины таблицы подряд: по CHANNEL_PINS на строку (DO, CS, нагреватель, DT, CLK, SW).
+#define CHANNEL_PINS 6
+constexpr uint8_t channelPin(uint8_t k) {
+    return k % CHANNEL_PINS == 0 ? CHANNEL_TABLE[k / CHANNEL_PINS].tcDataPin :
+           k % CHANNEL_PINS == 1 ? CHANNEL_TABLE[k / CHANNEL_PINS].tcCsPin :
+           k % CHANNEL_PINS == 2 ? CHANNEL_TABLE[k / CHANNEL_PINS].heaterPin :
+           k % CHANNEL_PINS == 3 ? CHANNEL_TABLE[k / CHANNEL_PINS].encDtPin :
+           k % CHANNEL_PINS == 4 ? CHANNEL_TABLE[k / CHANNEL_PINS].encClkPin :
+                                   CHANNEL_TABLE[k / CHANNEL_PINS].encSwPin;
+}
+
+// Пин k не совпадает ни с одним пином таблицы с номера j и дальше.
+constexpr bool channelPinUnique(uint8_t k, uint8_t j) {
+    return j >= NUM_CHANNELS * CHANNEL_PINS ||
+           (channelPin(k) != channelPin(j) && channelPinUnique(k, j + 1));
+}
+
+// Все пины таблицы различны, не на флеши (GPIO6..11) и не заняты общими линиями (CLK термопар,
+// буззер, I2C). Выходы и входы с подтяжкой - ниже 34; на 34..39 допускается только DO.
+// DO - вход и может совпадать только с общей линией TC_SPI_MISO_PIN.
+constexpr bool channelPinsValid(uint8_t k = 0) {
+    return k >= NUM_CHANNELS * CHANNEL_PINS ||
+           (channelPin(k) <= 39 &&
+            !(channelPin(k) >= 6 && channelPin(k) <= 11) &&
+            (k % CHANNEL_PINS == 0 || channelPin(k) < 34) &&
+            (k % CHANNEL_PINS == 0 || channelPin(k) != TC_SPI_MISO_PIN) &&
+            channelPin(k) != TC_CLK_PIN &&
+            channelPin(k) != BUZZER_PIN &&
+            channelPin(k) != I2C_SDA_PIN &&
+            channelPin(k) != I2C_SCL_PIN &&
+#ifdef POWER_WARN_PIN
+            channelPin(k) != POWER_WARN_PIN &&
+#endif
+            channelPinUnique(k, k + 1) &&
+            channelPinsValid(k + 1));
+}
+
+static_assert(sizeof(CHANNEL_TABLE) / sizeof(CHANNEL_TABLE[0]) == NUM_CHANNELS,
+              "CHANNEL_TABLE должна содержать ровно NUM_CHANNELS строк");
+static_assert(NUM_CHANNELS <= LEDC_TOTAL_CHANNELS, "Каналов больше, чем каналов LEDC");
+static_assert(NUM_CHANNELS <= 32, "Маски каналов 32-битные");
+static_assert(channelTableValid(), "Некорректная строка CHANNEL_TABLE (канал/таймер LEDC вне диапазона, повторяется "
+                                   "или занят буззером, либо уставки)");
+static_assert(channelPinsValid(), "Пины CHANNEL_TABLE повторяются, попадают на флешь (GPIO6..11), "
+                                  "на общие линии или выход назначен на пин только для входа");
+
+// Группа LEDC и номер канала внутри группы по сквозному номеру pwmChannel.
+inline ledc_mode_t pwmSpeedMode(uint8_t pwmChannel) {
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+    return pwmChannel < LEDC_GROUP_CHANNELS ? LEDC_LOW_SPEED_MODE : LEDC_HIGH_SPEED_MODE;
+#else
+    return LEDC_LOW_SPEED_MODE;
+#endif
+}
+inline ledc_channel_t pwmGroupChannel(uint8_t pwmChannel) {
+    return static_cast<ledc_channel_t>(pwmChannel % LEDC_GROUP_CHANNELS);
+}
+
+#endif
@@ -8,40 +8,140 @@
 // Размеры дисплея
 #define DISPLAY_WIDTH 20
 #define DISPLAY_HEIGHT 4
+// Частота шины I2C дисплея (Гц). PCF8574 по спецификации - 100 кГц, на практике работает и на 400 кГц
+#define LCD_I2C_CLOCK_HZ 100000
+// Пины I2C дисплея (в CHANNEL_TABLE их не занимать)
+#define I2C_SDA_PIN 21
+#define I2C_SCL_PIN 22
+// Задача дисплея: минимальный интервал между кадрами (мс), полупериод мигания уставки (мс), приоритет
+#define DISPLAY_MIN_FRAME_MS 100
+#define DISPLAY_BLINK_MS 500
+#define DISPLAY_TASK_PRIORITY 1
 
 // Параметры PWM
 #define PWM_FREQUENCY 5000
 #define PWM_RESOLUTION 8
 #define PWM_MAX_DUTY 255
 
-// Диапазон уставок температуры
+// Диапазон уставок температуры (значения по умолчанию для строк CHANNEL_TABLE)
 #define MIN_SETPOINT 0.0
 #define MAX_SETPOINT 500.0
 #define DEFAULT_SETPOINT 100.0
+// Предел калибровочного смещения датчика (°C); сохранённое значение вне предела сбрасывается в 0
+#define MAX_CALIB_OFFSET 50.0
+
+// Журнал настроек: метка раздела данных во флеш (partitions.csv)
+#define SETTINGS_PARTITION_LABEL "settings"
+// Задача сохранения: пауза в правках перед записью (мс), наибольшая задержка от первой правки (мс), приоритет.
+// POWER_WARN_PIN - вход от супервизора питания (активный спад) для немедленного сохранения, если он есть.
+#define PERSIST_QUIET_MS 3000
+#define PERSIST_MAX_DELAY_MS 30000
+#define PERSIST_TASK_PRIORITY 1
+// #define POWER_WARN_PIN 34
+
+// Журнал температур: метка раздела во флеш (partitions.csv), длина очереди снимков
+// (сколько циклов управления переживает запись блока), приоритет задачи журнала
+#define LOG_PARTITION_LABEL "datalog"
+#define LOG_QUEUE_LENGTH 8
+#define LOG_TASK_PRIORITY 1
 
 // Стартовые коэффициенты PID-регулятора
 #define PID_KP 10.0
 #define PID_KI 0.1
 #define PID_KD 5.0
+// Предел коэффициентов PID в сохранённой конфигурации (Q16.16 банка PID: Kd / dt не должен переполниться)
+#define PID_GAIN_MAX 1000.0
+
+// Период задачи управления (мс) и максимальное время преобразования MAX6675 (мс).
+// Чтение во время преобразования прерывает его, поэтому датчик опрашивается не чаще
+// раза в MAX6675_CONVERSION_MS: при периоде 125 мс - каждый второй цикл (250 мс).
+#define CONTROL_PERIOD_MS 125
+#define MAX6675_CONVERSION_MS 220
+
+// Задача управления работает на отдельном ядре с приоритетом выше задач интерфейса.
+// Цикл считается пропущенным, если стартовал позже CONTROL_JITTER_LIMIT_US
+// или не закончился до следующего запуска.
+#define CONTROL_TASK_PRIORITY 5
+#define CONTROL_TASK_CORE 1
+#define UI_TASK_CORE 0
+#define CONTROL_JITTER_LIMIT_US 2000
+#define CONTROL_STATS_PERIOD_MS 10000
+// Надзор за задачей управления: предел времени без цикла (мс) и период проверки (мс).
+// При пропуске срока выходы нагревателей снимаются независимо от состояния задачи.
+#define CONTROL_WATCHDOG_DEADLINE_MS (3 * CONTROL_PERIOD_MS)
+#define CONTROL_WATCHDOG_CHECK_MS 25
+// Стирание сектора флеш (до 400 мс по даташитам W25Q32/GD25Q32, типично 45 мс) останавливает оба ядра,
+// что больше срока надзора. На время операции (PartitionFlash) надзор приостанавливается, но не дольше
+// CONTROL_WATCHDOG_FLASH_MAX_MS, а после неё срок без цикла отсчитывается заново от её конца.
+#define CONTROL_WATCHDOG_FLASH_MAX_MS 500
+
+// Ввод с энкодеров: длина очереди событий, период опроса занятых кнопок (мс), приоритет задачи распознавания,
+// таймауты режима настройки уставки (мс)
+#define INPUT_QUEUE_LENGTH 16
+#define INPUT_POLL_MS 10
+#define INPUT_TASK_PRIORITY 3
+#define SETPOINT_EDIT_TIMEOUT_MS 5000
+
+// Аварийное отключение: приоритет задачи обработки аварии (выше задачи управления)
+// и предел задержки быстрого пути для SHUTDOWN_SELFTEST (мкс)
+#define EMERGENCY_TASK_PRIORITY 6
+#define SHUTDOWN_MAX_LATENCY_US 5
+
+// История температур в RAM по уровням: уровень 0 - каждый цикл управления, уровни 1 и 2 - min/max/среднее
+// за период. Глубина каждого уровня (мс) задаёт размер колец на этапе компиляции.
+// Глубины указаны для HISTORY_REF_CHANNELS каналов (1 мин, 1 ч, 24 ч) и при большем NUM_CHANNELS
+// сокращаются пропорционально, чтобы память под историю оставалась в пределах HISTORY_RAM_BUDGET
+// (проверяется static_assert в History.cpp; при 3 каналах - ~72 КБ, при 16 - ~73 КБ).
+#define HISTORY_RAM_BUDGET 80000UL
+#define HISTORY_REF_CHANNELS 3
+#define HISTORY_SPAN_SCALE(span) ((span) * HISTORY_REF_CHANNELS / \
+    (NUM_CHANNELS > HISTORY_REF_CHANNELS ? NUM_CHANNELS : HISTORY_REF_CHANNELS))
+#define HISTORY_TIER0_SPAN_MS HISTORY_SPAN_SCALE(60000UL)
+#define HISTORY_TIER1_PERIOD_MS 1000UL
+#define HISTORY_TIER1_SPAN_MS HISTORY_SPAN_SCALE(3600000UL)
+#define HISTORY_TIER2_PERIOD_MS 60000UL
+#define HISTORY_TIER2_SPAN_MS HISTORY_SPAN_SCALE(86400000UL)
+
+// Размер кольцевого буфера отсчётов на канал (степень двойки; 16 отсчётов = 4 с при 250 мс)
+#define SAMPLE_RING_SIZE 16
+
+// Фильтрация показаний термопар (см. TemperatureFilter): медиана для подавления выбросов,
+// затем сглаживание. Тип сглаживания: FILTER_NONE, FILTER_EMA, FILTER_IIR1 или FILTER_IIR2;
+// параметр - alpha для FILTER_EMA или частота среза в Гц для FILTER_IIR1/FILTER_IIR2.
+#define FILTER_MEDIAN_MAX 7
+#define FILTER_MEDIAN_SIZE 3
+#define FILTER_SMOOTH_TYPE FILTER_IIR2
+#define FILTER_SMOOTH_PARAM 0.3
+// Фильтр стоит внутри контура PID и добавляет запаздывание. Цепочка по умолчанию (медиана 3, IIR2 0.3 Гц
+// при 4 Гц отсчётов): 50 % скачка через 4 отсчёта (1 с), 90 % - через 7 (1.75 с), перерегулирование < 5 %
+// (проверяется в test/test_filter). Это на порядок меньше постоянной времени нагревателя (десятки секунд,
+// SIM_TIME_CONSTANT_MS), фазовый сдвиг на частоте среза контура - единицы градусов, поэтому PID_KP/KI/KD
+// не перенастраивались. При повышении FILTER_SMOOTH_PARAM запаздывание падает, но растёт шум D-составляющей;
+// при понижении - наоборот, и Kd стоит уменьшить.
+
+// Общий CLK термопар MAX6675 (DO и CS каждого канала - в CHANNEL_TABLE, ChannelTable.h)
+#define TC_CLK_PIN 18
+
+// Источник данных термопар: по умолчанию программный пакет на общем CLK (MAX6675Bus).
+// TC_BACKEND_SPI включает аппаратный SPI с DMA (MAX6675SpiBus); при этом выходы DO
+// всех модулей объединяются на линии TC_SPI_MISO_PIN, а CLK остаётся на TC_CLK_PIN.
+// TC_BACKEND_SIM подменяет датчики моделью нагрева (SimulatedSensor) для отладки без железа.
+// #define TC_BACKEND_SPI
+// #define TC_BACKEND_SIM
+#define TC_SPI_HOST SPI3_HOST
+#define TC_SPI_MISO_PIN 35  // Совпадает с DO первой строки CHANNEL_TABLE
+#define TC_SPI_CLOCK_HZ 1000000
 
-// Назначение пинов энкодеров (DT, CLK, SW)
-#define ENC1_DT 2
-#define ENC1_CLK 3
-#define ENC1_SW 4
-#define ENC2_DT 5
-#define ENC2_CLK 6
-#define ENC2_SW 7
-#define ENC3_DT 8
-#define ENC3_CLK 9
-#define ENC3_SW 10
-
-// Назначение пинов нагревателей
-#define HEATER1_PIN 11
-#define HEATER2_PIN 12
-#define HEATER3_PIN 13
+// Параметры модели нагрева для TC_BACKEND_SIM
+#define SIM_AMBIENT_TEMP 25.0     // Температура окружающей среды, °C
+#define SIM_MAX_RISE 450.0        // Установившийся перегрев при 100% мощности, °C
+#define SIM_TIME_CONSTANT_MS 60000 // Постоянная времени объекта, мс
 
 // Пин и канал для буззера
 #define BUZZER_PIN 14
 #define BUZZER_CHANNEL 3
+// Очередь запросов буззера и приоритет задачи-секвенсора (ниже задач интерфейса)
+#define BUZZER_QUEUE_LENGTH 8
+#define BUZZER_TASK_PRIORITY 1
 
 #endif
@@ -0,0 +1,192 @@
+// ConfigSchema.cpp
+// Схема сохраняемой конфигурации: значения по умолчанию, пределы и миграция раскладок по таблице полей.
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "ConfigSchema.h"
+#include "ChannelTable.h"
+
+// Описание поля ChannelConfig: где лежит, с какой версии есть, допустимый диапазон, значение по умолчанию.
+struct ConfigField {
+    uint8_t offset;
+    uint16_t sinceVersion;
+    bool isFlags;               // uint32_t с маской CONFIG_PID_FLAGS_MASK вместо float с диапазоном
+    float minValue;
+    float maxValue;
+    float (*defaultValue)(uint8_t channel);
+};
+
+static float defaultSetpoint(uint8_t ch) { return CHANNEL_TABLE[ch].defaultSetpoint; }
+static float defaultZero(uint8_t ch) { (void)ch; return 0.0f; }
+static float defaultKp(uint8_t ch) { (void)ch; return PID_KP; }
+static float defaultKi(uint8_t ch) { (void)ch; return PID_KI; }
+static float defaultKd(uint8_t ch) { (void)ch; return PID_KD; }
+static float defaultMinSetpoint(uint8_t ch) { return CHANNEL_TABLE[ch].minSetpoint; }
+static float defaultMaxSetpoint(uint8_t ch) { return CHANNEL_TABLE[ch].maxSetpoint; }
+static float defaultMaxOutput(uint8_t ch) { (void)ch; return PWM_MAX_DUTY; }
+
+#define CHANNEL_FIELD(member, since, lo, hi, def) \
+    { static_cast<uint8_t>(offsetof(ChannelConfig, member)), since, false, lo, hi, def }
+
+static const ConfigField CHANNEL_FIELDS[] = {
+    CHANNEL_FIELD(setpoint,          1, MIN_SETPOINT, MAX_SETPOINT, defaultSetpoint),
+    CHANNEL_FIELD(calibrationOffset, 1, -MAX_CALIB_OFFSET, MAX_CALIB_OFFSET, defaultZero),
+    CHANNEL_FIELD(kp,                1, 0.0f, PID_GAIN_MAX, defaultKp),
+    CHANNEL_FIELD(ki,                1, 0.0f, PID_GAIN_MAX, defaultKi),
+    CHANNEL_FIELD(kd,                1, 0.0f, PID_GAIN_MAX, defaultKd),
+    CHANNEL_FIELD(minSetpoint,       1, MIN_SETPOINT, MAX_SETPOINT, defaultMinSetpoint),
+    CHANNEL_FIELD(maxSetpoint,       1, MIN_SETPOINT, MAX_SETPOINT, defaultMaxSetpoint),
+    CHANNEL_FIELD(maxOutput,         1, 0.0f, PWM_MAX_DUTY, defaultMaxOutput),
+    { static_cast<uint8_t>(offsetof(ChannelConfig, pidFlags)), 1, true, 0.0f, 0.0f, defaultZero },
+};
+static const size_t CHANNEL_FIELD_COUNT = sizeof(CHANNEL_FIELDS) / sizeof(CHANNEL_FIELDS[0]);
+static_assert(sizeof(CHANNEL_FIELDS) / sizeof(CHANNEL_FIELDS[0]) * 4 == sizeof(ChannelConfig),
+              "Каждое поле ChannelConfig описано в CHANNEL_FIELDS");
+
+static void setDefault(ChannelConfig& cfg, const ConfigField& f, uint8_t ch) {
+    uint8_t* p = reinterpret_cast<uint8_t*>(&cfg) + f.offset;
+    if (f.isFlags) {
+        uint32_t v = static_cast<uint32_t>(f.defaultValue(ch));
+        memcpy(p, &v, sizeof(v));
+    } else {
+        float v = f.defaultValue(ch);
+        memcpy(p, &v, sizeof(v));
+    }
+}
+
+static void channelDefaults(ChannelConfig& cfg, uint8_t ch) {
+    for (size_t k = 0; k < CHANNEL_FIELD_COUNT; k++) setDefault(cfg, CHANNEL_FIELDS[k], ch);
+}
+
+static void currentHeader(ConfigHeader& h) {
+    h.version = CONFIG_VERSION;
+    h.channelCount = NUM_CHANNELS;
+    h.channelStride = sizeof(ChannelConfig);
+}
+
+void configDefaults(ConfigBlob& blob) {
+    currentHeader(blob.header);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) channelDefaults(blob.channels[ch], ch);
+}
+
+uint16_t configValidate(ConfigBlob& blob) {
+    uint16_t fixed = 0;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+        ChannelConfig& cfg = blob.channels[ch];
+        for (size_t k = 0; k < CHANNEL_FIELD_COUNT; k++) {
+            const ConfigField& f = CHANNEL_FIELDS[k];
+            uint8_t* p = reinterpret_cast<uint8_t*>(&cfg) + f.offset;
+            bool ok;
+            if (f.isFlags) {
+                uint32_t v;
+                memcpy(&v, p, sizeof(v));
+                ok = (v & ~static_cast<uint32_t>(CONFIG_PID_FLAGS_MASK)) == 0;
+            } else {
+                float v;
+                memcpy(&v, p, sizeof(v));
+                ok = isfinite(v) && v >= f.minValue && v <= f.maxValue;
+            }
+            if (!ok) {
+                setDefault(cfg, f, ch);
+                fixed++;
+            }
+        }
+
+        // Связи между полями: пределы уставки - внутри аппаратных пределов канала, уставка - внутри пределов
+        const ChannelDescriptor& desc = CHANNEL_TABLE[ch];
+        if (cfg.minSetpoint < desc.minSetpoint || cfg.maxSetpoint > desc.maxSetpoint || cfg.minSetpoint >= cfg.maxSetpoint) {
+            cfg.minSetpoint = desc.minSetpoint;
+            cfg.maxSetpoint = desc.maxSetpoint;
+            fixed += 2;
+        }
+        if (cfg.setpoint < cfg.minSetpoint || cfg.setpoint > cfg.maxSetpoint) {
+            cfg.setpoint = constrain(cfg.setpoint, cfg.minSetpoint, cfg.maxSetpoint);
+            fixed++;
+        }
+    }
+    return fixed;
+}
+
+// Запись до схемы: уставки и смещения, остальное - по умолчанию.
+static bool decodeV0(ConfigLoadBuffer& buf, size_t length, ConfigLoadReport& report) {
+    float setpoints[NUM_CHANNELS];
+    float offsets[NUM_CHANNELS];
+    if (length != sizeof(setpoints) + sizeof(offsets)) return false;
+    memcpy(setpoints, buf.raw, sizeof(setpoints));
+    memcpy(offsets, buf.raw + sizeof(setpoints), sizeof(offsets));
+
+    configDefaults(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+        buf.blob.channels[ch].setpoint = setpoints[ch];
+        buf.blob.channels[ch].calibrationOffset = offsets[ch];
+    }
+    report.fromVersion = 0;
+    report.migrated = true;
+    report.defaulted = NUM_CHANNELS * (CHANNEL_FIELD_COUNT - 2);
+    return true;
+}
+
+// Другая раскладка блоба: каналы переносятся на шаг sizeof(ChannelConfig) прямо в буфере,
+// поля, которых в записи нет (шаг короче или версия старше поля), заполняются по умолчанию.
+static void relayout(ConfigLoadBuffer& buf, const ConfigHeader& h, size_t length, ConfigLoadReport& report) {
+    const size_t newStride = sizeof(ChannelConfig);
+    const size_t oldStride = h.channelStride;
+    size_t available = length > sizeof(ConfigHeader) ? (length - sizeof(ConfigHeader)) / oldStride : 0;
+    if (available > h.channelCount) available = h.channelCount;
+    if (available > NUM_CHANNELS) available = NUM_CHANNELS;
+    const size_t copyBytes = oldStride < newStride ? oldStride : newStride;
+
+    uint8_t* base = buf.raw + sizeof(ConfigHeader);
+    // Сдвиг вправо - от последнего канала, влево - от первого, чтобы не затереть ещё не перенесённые
+    if (oldStride < newStride) {
+        for (size_t k = available; k-- > 0;) memmove(base + k * newStride, base + k * oldStride, copyBytes);
+    } else if (oldStride > newStride) {
+        for (size_t k = 0; k < available; k++) memmove(base + k * newStride, base + k * oldStride, copyBytes);
+    }
+
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+        ChannelConfig& cfg = buf.blob.channels[ch];
+        if (ch >= available) {
+            channelDefaults(cfg, ch);
+            report.defaulted += CHANNEL_FIELD_COUNT;
+            continue;
+        }
+        for (size_t k = 0; k < CHANNEL_FIELD_COUNT; k++) {
+            const ConfigField& f = CHANNEL_FIELDS[k];
+            if (f.offset + sizeof(float) > copyBytes || f.sinceVersion > h.version) {
+                setDefault(cfg, f, ch);
+                report.defaulted++;
+            }
+        }
+    }
+}
+
+bool configDecode(ConfigLoadBuffer& buf, size_t length, uint16_t tag, ConfigLoadReport& report) {
+    report.fromVersion = 0;
+    report.migrated = false;
+    report.defaulted = 0;
+
+    bool ok = false;
+    if (tag == CONFIG_RECORD_TAG_V0) {
+        ok = decodeV0(buf, length, report);
+    } else if (tag == CONFIG_RECORD_TAG && length >= sizeof(ConfigHeader)) {
+        ConfigHeader h = buf.blob.header;
+        if (h.version > 0 && h.channelStride >= 4 && h.channelStride % 4 == 0) {
+            report.fromVersion = h.version;
+            bool sameLayout = h.version == CONFIG_VERSION && h.channelStride == sizeof(ChannelConfig) &&
+                              h.channelCount == NUM_CHANNELS && length == sizeof(ConfigBlob);
+            if (!sameLayout) {
+                report.migrated = true;
+                relayout(buf, h, length < sizeof(buf.raw) ? length : sizeof(buf.raw), report);
+            }
+            ok = true;
+        }
+    }
+    if (!ok) {
+        configDefaults(buf.blob);
+        return false;
+    }
+    report.defaulted += configValidate(buf.blob);
+    currentHeader(buf.blob.header);
+    return true;
+}
@@ -0,0 +1,78 @@
+// ConfigSchema.h
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include "Config.h"
+
+// Версия схемы конфигурации. Новое поле канала добавляется в конец ChannelConfig
+// с sinceVersion = новой версии в CHANNEL_FIELDS (ConfigSchema.cpp) и увеличением CONFIG_VERSION;
+// старые записи дополняются значениями по умолчанию без отдельного кода миграции.
+#define CONFIG_VERSION 1
+
+// Метки записей журнала настроек
+#define CONFIG_RECORD_TAG_V0 1  // До схемы: float setpoint[NUM_CHANNELS], float calibrationOffset[NUM_CHANNELS]
+#define CONFIG_RECORD_TAG 2     // ConfigBlob
+
+// Флаги ChannelConfig::pidFlags
+#define CONFIG_PID_REVERSE 0x01  // Обратное направление регулирования
+#define CONFIG_PID_ON_RATE 0x02  // Пропорциональная часть по скорости изменения входа
+#define CONFIG_PID_FLAGS_MASK (CONFIG_PID_REVERSE | CONFIG_PID_ON_RATE)
+
+// Настройки одного канала. Только 4-байтные поля: структура упакована без выравнивающих промежутков,
+// сравнивается memcmp и пишется во флеш как есть.
+struct ChannelConfig {
+    float setpoint;             // Уставка, °C
+    float calibrationOffset;    // Калибровочное смещение датчика, °C
+    float kp;                   // Коэффициенты PID (в том числе от autoTunePID())
+    float ki;
+    float kd;
+    float minSetpoint;          // Пределы уставки (внутри пределов CHANNEL_TABLE)
+    float maxSetpoint;
+    float maxOutput;            // Ограничение выхода PID, 0..PWM_MAX_DUTY
+    uint32_t pidFlags;          // CONFIG_PID_*
+};
+
+// Заголовок блоба: по нему загрузчик понимает раскладку записавшей прошивки.
+struct ConfigHeader {
+    uint16_t version;           // CONFIG_VERSION записавшей прошивки
+    uint8_t channelCount;       // NUM_CHANNELS записавшей прошивки
+    uint8_t channelStride;      // sizeof(ChannelConfig) записавшей прошивки
+};
+
+// Вся сохраняемая конфигурация - одна запись журнала, читается одним чтением.
+struct ConfigBlob {
+    ConfigHeader header;
+    ChannelConfig channels[NUM_CHANNELS];
+};
+
+static_assert(sizeof(ChannelConfig) == 9 * 4, "ChannelConfig без промежутков");
+static_assert(sizeof(ConfigHeader) == 4, "ConfigHeader - 4 байта");
+static_assert(sizeof(ConfigBlob) == sizeof(ConfigHeader) + NUM_CHANNELS * sizeof(ChannelConfig), "ConfigBlob упакован");
+static_assert(sizeof(ChannelConfig) <= 255 && NUM_CHANNELS <= 255, "Шаг и число каналов помещаются в заголовок");
+
+// Буфер загрузки: блоб текущей версии или запись другой раскладки (старой или более новой прошивки) -
+// разбирается на месте, без второй копии.
+union ConfigLoadBuffer {
+    ConfigBlob blob;
+    uint8_t raw[sizeof(ConfigBlob) + 64];
+};
+
+// Итог разбора записи.
+struct ConfigLoadReport {
+    uint16_t fromVersion;       // Версия записи (0 - запись до схемы)
+    bool migrated;              // Раскладка отличалась от текущей
+    uint16_t defaulted;         // Полей, заполненных значениями по умолчанию (нет в записи или вне пределов)
+};
+
+// Значения по умолчанию для всех полей.
+void configDefaults(ConfigBlob& blob);
+// Разбор записи журнала длиной length с меткой tag, лежащей в buf, в buf.blob.
+// Текущая раскладка проверяется на месте; другая приводится к текущей (тоже на месте).
+// false - запись не похожа на конфигурацию (buf.blob тогда заполнен значениями по умолчанию).
+bool configDecode(ConfigLoadBuffer& buf, size_t length, uint16_t tag, ConfigLoadReport& report);
+// Проверка полей блоба: значения вне пределов заменяются значениями по умолчанию. Возвращает их число.
+uint16_t configValidate(ConfigBlob& blob);
+
+#endif
@@ -0,0 +1,185 @@
+// ControlTiming.cpp
+// Учёт джиттера и пропущенных дедлайнов задачи управления нагревателями.
+#include <Arduino.h>
+#include <string.h>
+#include <esp_timer.h>
+#include "ControlTiming.h"
+#include "Emergency.h"
+
+ControlTiming controlTiming(CONTROL_PERIOD_MS * 1000UL, CONTROL_JITTER_LIMIT_US);
+
+ControlTiming::ControlTiming(uint32_t periodUs, uint32_t jitterLimitUs)
+    : periodUs(periodUs), jitterLimitUs(jitterLimitUs), nextRelease(0), startTime(0),
+      started(false), missedThisCycle(false)
+{
+    memset(&stats, 0, sizeof(stats));
+    mux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+void ControlTiming::cycleStart() {
+    startTime = esp_timer_get_time();
+    if (!started) {
+        // Первый цикл задаёт опорную сетку моментов запуска
+        nextRelease = startTime;
+        started = true;
+    }
+    int32_t jitter = static_cast<int32_t>(startTime - nextRelease);
+    missedThisCycle = jitter > static_cast<int32_t>(jitterLimitUs);
+
+    portENTER_CRITICAL(&mux);
+    stats.lastJitterUs = jitter;
+    if (abs(jitter) > abs(stats.maxJitterUs)) stats.maxJitterUs = jitter;
+    portEXIT_CRITICAL(&mux);
+}
+
+void ControlTiming::cycleEnd() {
+    int64_t endTime = esp_timer_get_time();
+    uint32_t exec = static_cast<uint32_t>(endTime - startTime);
+    // Цикл должен закончиться до идеального момента следующего запуска
+    if (endTime > nextRelease + periodUs) missedThisCycle = true;
+    nextRelease += periodUs;
+
+    portENTER_CRITICAL(&mux);
+    stats.cycles++;
+    stats.lastExecUs = exec;
+    if (exec > stats.maxExecUs) stats.maxExecUs = exec;
+    stats.totalExecUs += exec;
+    if (missedThisCycle) stats.missedDeadlines++;
+    portEXIT_CRITICAL(&mux);
+}
+
+ControlTimingStats ControlTiming::snapshot(bool reset) {
+    portENTER_CRITICAL(&mux);
+    ControlTimingStats copy = stats;
+    if (reset) memset(&stats, 0, sizeof(stats));
+    portEXIT_CRITICAL(&mux);
+    return copy;
+}
+
+void reportControlTiming() {
+    ControlTimingStats s = controlTiming.snapshot(true);
+    if (s.cycles == 0) {
+        Serial.println("[CONTROL] Задача управления не выполнялась!");
+        return;
+    }
+    Serial.printf("[CONTROL] циклов %u, пропущено дедлайнов %u, джиттер макс %d мкс, "
+                  "выполнение ср %u / макс %u мкс\n",
+                  s.cycles, s.missedDeadlines, s.maxJitterUs,
+                  static_cast<uint32_t>(s.totalExecUs / s.cycles), s.maxExecUs);
+}
+
+ControlWatchdog controlWatchdog(CONTROL_WATCHDOG_DEADLINE_MS * 1000UL, CONTROL_WATCHDOG_CHECK_MS * 1000UL,
+                                CONTROL_WATCHDOG_FLASH_MAX_MS * 1000UL);
+
+static const char* phaseName(uint32_t phase) {
+    switch (phase) {
+        case CONTROL_PHASE_IDLE:       return "ожидание периода";
+        case CONTROL_PHASE_WAIT_MUTEX: return "захват systemMutex";
+        case CONTROL_PHASE_ACQUIRE:    return "опрос датчиков";
+        case CONTROL_PHASE_PID:        return "расчёт PID";
+        case CONTROL_PHASE_PUBLISH:    return "публикация состояния";
+        default:                       return "?";
+    }
+}
+
+static const char* taskStateName(eTaskState state) {
+    switch (state) {
+        case eRunning:   return "выполняется";
+        case eReady:     return "готова";
+        case eBlocked:   return "заблокирована";
+        case eSuspended: return "приостановлена";
+        default:         return "удалена";
+    }
+}
+
+ControlWatchdog::ControlWatchdog(uint32_t deadlineUs, uint32_t checkPeriodUs, uint32_t flashMaxUs)
+    : deadlineUs(deadlineUs), checkPeriodUs(checkPeriodUs), flashMaxUs(flashMaxUs), controlTask(NULL), timer(NULL),
+      lastFeedUs(0), phase(CONTROL_PHASE_IDLE), phaseStartUs(0), armed(false),
+      flashOps(0), flashStartUs(0), flashDone(0), seenFlashDone(0), graceStartUs(0), grace(false), trips(0)
+{
+    memset(&lastTrip, 0, sizeof(lastTrip));
+}
+
+void ControlWatchdog::begin(TaskHandle_t controlTask) {
+    this->controlTask = controlTask;
+    esp_timer_create_args_t args;
+    memset(&args, 0, sizeof(args));
+    args.callback = &ControlWatchdog::onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "ctl_wdt";
+    if (esp_timer_create(&args, &timer) != ESP_OK || esp_timer_start_periodic(timer, checkPeriodUs) != ESP_OK) {
+        Serial.println("[WATCHDOG] Не удалось запустить таймер надзора!");
+    }
+}
+
+void ControlWatchdog::feed() {
+    lastFeedUs.store(static_cast<uint32_t>(esp_timer_get_time()), std::memory_order_release);
+    armed.store(true, std::memory_order_release);
+}
+
+void ControlWatchdog::setPhase(ControlPhase phase) {
+    phaseStartUs.store(static_cast<uint32_t>(esp_timer_get_time()), std::memory_order_relaxed);
+    this->phase.store(phase, std::memory_order_release);
+}
+
+void ControlWatchdog::flashBegin() {
+    if (flashOps.load(std::memory_order_relaxed) == 0) {
+        flashStartUs.store(static_cast<uint32_t>(esp_timer_get_time()), std::memory_order_relaxed);
+    }
+    flashOps.fetch_add(1, std::memory_order_release);
+}
+
+void ControlWatchdog::flashEnd() {
+    flashDone.fetch_add(1, std::memory_order_relaxed);
+    flashOps.fetch_sub(1, std::memory_order_release);
+}
+
+void ControlWatchdog::onTimer(void* arg) {
+    static_cast<ControlWatchdog*>(arg)->check();
+}
+
+// Выполняется в задаче esp_timer: только сравнение и, при пропуске срока, снятие выходов.
+void ControlWatchdog::check() {
+    if (!armed.load(std::memory_order_acquire) || heatersTripped()) return;
+    uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+    // Операция с флешью: ядра могли стоять, срок не считается - в пределах flashMaxUs
+    if (flashOps.load(std::memory_order_acquire) &&
+        now - flashStartUs.load(std::memory_order_relaxed) <= flashMaxUs) return;
+    // Операция завершилась: задаче управления - полный срок от момента, когда это замечено
+    uint32_t done = flashDone.load(std::memory_order_relaxed);
+    if (done != seenFlashDone) {
+        seenFlashDone = done;
+        graceStartUs = now;
+        grace = true;
+    }
+    if (grace) {
+        if (now - graceStartUs <= deadlineUs) return;
+        grace = false;
+    }
+    uint32_t age = now - lastFeedUs.load(std::memory_order_acquire);
+    if (age <= deadlineUs) return;
+
+    // Сначала выходы, затем контекст
+    heatersOffFast(SHUTDOWN_WATCHDOG);
+    lastTrip.feedAgeUs = age;
+    lastTrip.phase = static_cast<ControlPhase>(phase.load(std::memory_order_acquire));
+    lastTrip.phaseAgeUs = now - phaseStartUs.load(std::memory_order_relaxed);
+    lastTrip.controlState = controlTask ? eTaskGetState(controlTask) : eInvalid;
+    TaskHandle_t running = xTaskGetCurrentTaskHandleForCPU(CONTROL_TASK_CORE);
+    lastTrip.coreTask = running ? pcTaskGetName(running) : "-";
+    lastTrip.timing = controlTiming.snapshot(false);
+    trips++;
+}
+
+void ControlWatchdog::report() {
+    const WatchdogTripInfo& t = lastTrip;
+    Serial.printf("[WATCHDOG] Срабатывание #%u: нет цикла управления %u мкс (предел %u мкс)\n",
+                  trips, t.feedAgeUs, deadlineUs);
+    Serial.printf("[WATCHDOG] Задача управления: %s, фаза \"%s\" уже %u мкс; на ядре %d - \"%s\"\n",
+                  taskStateName(t.controlState), phaseName(t.phase), t.phaseAgeUs, CONTROL_TASK_CORE, t.coreTask);
+    Serial.printf("[WATCHDOG] До срабатывания: циклов %u, пропущено дедлайнов %u, джиттер посл/макс %d/%d мкс, "
+                  "выполнение посл/макс %u/%u мкс\n",
+                  t.timing.cycles, t.timing.missedDeadlines, t.timing.lastJitterUs, t.timing.maxJitterUs,
+                  t.timing.lastExecUs, t.timing.maxExecUs);
+}
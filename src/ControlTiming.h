@@ -0,0 +1,119 @@
+// ControlTiming.h
+#ifndef CONTROL_TIMING_H
+#define CONTROL_TIMING_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Config.h"
+
+// Статистика времени цикла задачи управления (все значения в мкс).
+struct ControlTimingStats {
+    uint32_t cycles;          // Число циклов
+    uint32_t missedDeadlines; // Циклов, начатых позже допуска или не закончившихся до следующего запуска
+    int32_t lastJitterUs;     // Отклонение старта последнего цикла от идеального момента
+    int32_t maxJitterUs;      // Максимальное отклонение старта
+    uint32_t lastExecUs;      // Время выполнения последнего цикла
+    uint32_t maxExecUs;       // Максимальное время выполнения
+    uint64_t totalExecUs;     // Суммарное время выполнения (для среднего)
+};
+
+// Учёт джиттера старта и времени выполнения периодической задачи управления.
+// cycleStart()/cycleEnd() вызываются только задачей управления; snapshot() - из любой задачи.
+class ControlTiming {
+public:
+    ControlTiming(uint32_t periodUs, uint32_t jitterLimitUs);
+
+    void cycleStart();
+    void cycleEnd();
+    // Копия статистики; при reset обнуляет накопленные значения.
+    ControlTimingStats snapshot(bool reset);
+    uint32_t getPeriodUs() const { return periodUs; }
+
+private:
+    uint32_t periodUs;
+    uint32_t jitterLimitUs;
+    int64_t nextRelease;   // Идеальный момент старта текущего цикла
+    int64_t startTime;
+    bool started;
+    bool missedThisCycle;
+    ControlTimingStats stats;
+    portMUX_TYPE mux;
+};
+
+extern ControlTiming controlTiming;
+
+// Вывод статистики задачи управления в Serial с обнулением максимумов.
+void reportControlTiming();
+
+// Фаза цикла задачи управления (контекст для журнала надзора)
+enum ControlPhase : uint32_t {
+    CONTROL_PHASE_IDLE,        // Ожидание следующего периода
+    CONTROL_PHASE_WAIT_MUTEX,  // Захват systemMutex
+    CONTROL_PHASE_ACQUIRE,     // Опрос датчиков и фильтрация
+    CONTROL_PHASE_PID,         // Расчёт PID и вывод ШИМ
+    CONTROL_PHASE_PUBLISH      // Публикация снимка состояния
+};
+
+// Контекст срабатывания надзора, снятый в момент пропуска срока.
+struct WatchdogTripInfo {
+    uint32_t feedAgeUs;         // Время с последнего feed()
+    ControlPhase phase;         // Фаза, в которой задача управления остановилась
+    uint32_t phaseAgeUs;        // Сколько она в этой фазе
+    eTaskState controlState;    // Состояние задачи управления по планировщику
+    const char* coreTask;       // Задача, занимавшая ядро управления
+    ControlTimingStats timing;  // Статистика циклов до срабатывания
+};
+
+// Надзор за задачей управления на периодическом esp_timer (задача esp_timer на ядре 0).
+// Задача управления вызывает feed() каждый цикл; если feed() не было дольше deadlineUs,
+// выходы нагревателей снимаются быстрым путём heatersOffFast(SHUTDOWN_WATCHDOG)
+// и сохраняется контекст для журнала. Время хранится в 32-битных мкс (переполнение - раз в 71 мин,
+// разность беззнаковая), чтобы атомарные операции оставались без блокировок.
+// Операции с флешью, останавливающие оба ядра, обрамляются flashBegin()/flashEnd(): на их время
+// надзор приостановлен (не дольше flashMaxUs), после них срок deadlineUs отсчитывается заново.
+class ControlWatchdog {
+public:
+    ControlWatchdog(uint32_t deadlineUs, uint32_t checkPeriodUs, uint32_t flashMaxUs);
+
+    // Запуск таймера проверки; controlTask - задача, за которой идёт надзор.
+    void begin(TaskHandle_t controlTask);
+    // Отметка живости задачи управления (раз в цикл). Первый вызов включает надзор.
+    void feed();
+    // Смена фазы цикла (только из задачи управления).
+    void setPhase(ControlPhase phase);
+    // Начало и конец операции с флешью (стирание, запись); из любой задачи, допускается вложенность.
+    void flashBegin();
+    void flashEnd();
+    // Вывод контекста последнего срабатывания в Serial (из задачи аварии).
+    void report();
+
+private:
+    uint32_t deadlineUs;
+    uint32_t checkPeriodUs;
+    uint32_t flashMaxUs;
+    TaskHandle_t controlTask;
+    esp_timer_handle_t timer;
+    std::atomic<uint32_t> lastFeedUs;
+    std::atomic<uint32_t> phase;
+    std::atomic<uint32_t> phaseStartUs;
+    std::atomic<bool> armed;
+    std::atomic<uint32_t> flashOps;      // Незавершённых операций с флешью
+    std::atomic<uint32_t> flashStartUs;  // Начало текущей операции
+    std::atomic<uint32_t> flashDone;     // Завершённых операций (счётчик для check())
+    // Состояние проверки (только задача esp_timer)
+    uint32_t seenFlashDone;
+    uint32_t graceStartUs;
+    bool grace;
+    uint32_t trips;
+    WatchdogTripInfo lastTrip;
+
+    static void onTimer(void* arg);
+    void check();
+};
+
+extern ControlWatchdog controlWatchdog;
+
+#endif
@@ -0,0 +1,12 @@
+// Crc32.h
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, полином 0xEDB88320, как у zlib). Для продолжения расчёта по частям
+// передаётся результат предыдущего вызова: crc32(b, nb, crc32(a, na)) == crc32(a+b).
+uint32_t crc32(const void* data, size_t len, uint32_t crc = 0);
+
+#endif
@@ -0,0 +1,94 @@
+// DataLog.cpp
+// Кольцо блоков журнала температур во флеш.
+#include <string.h>
+#include "DataLog.h"
+
+DataLog::DataLog(FlashRegion& flash)
+    : flash(flash), encoder(1, 0), blocksPerSector(0), blockCount(0), nextBlock(0), sequence(0), boot(0),
+      writeCount(0), eraseCount(0), failureCount(0), frameCount(0), byteCount(0) {}
+
+bool DataLog::begin(uint8_t channels, uint16_t periodMs) {
+    blocksPerSector = flash.sectorSize() / LOG_BLOCK_SIZE;
+    blockCount = blocksPerSector * flash.sectorCount();
+    if (blockCount == 0) return false;
+
+    // Новейший блок - по номеру; сравнение через разность переживает переполнение.
+    // Читаются только заголовки: CRC проверяет декодер, а оборванный блок всё равно самый новый.
+    bool found = false;
+    uint32_t newest = 0;
+    LogBlockHeader newestHeader;
+    memset(&newestHeader, 0, sizeof(newestHeader));
+    for (uint32_t b = 0; b < blockCount; b++) {
+        LogBlockHeader h;
+        if (!flash.read(b * LOG_BLOCK_SIZE, &h, sizeof(h))) continue;
+        if (h.magic != LOG_BLOCK_MAGIC || h.version != LOG_FORMAT_VERSION) continue;
+        if (!found || static_cast<int32_t>(h.sequence - newestHeader.sequence) > 0) {
+            found = true;
+            newest = b;
+            newestHeader = h;
+        }
+    }
+    nextBlock = found ? (newest + 1) % blockCount : 0;
+    sequence = found ? newestHeader.sequence + 1 : 0;
+    boot = found ? newestHeader.boot + 1 : 0;
+    writeCount = eraseCount = failureCount = frameCount = byteCount = 0;
+
+    encoder = LogEncoder(channels, periodMs);
+    encoder.start(sequence, boot);
+    return true;
+}
+
+bool DataLog::writeBlock(uint32_t index, const uint8_t* data) {
+    uint32_t sector = index / blocksPerSector;
+    if (index % blocksPerSector == 0) {
+        if (!flash.eraseSector(sector)) return false;
+        eraseCount++;
+    }
+    if (!flash.write(index * LOG_BLOCK_SIZE, data, LOG_BLOCK_SIZE)) return false;
+
+    // Проверка чтением: блок сравнивается кусками, без второго буфера на весь блок
+    uint8_t chunk[64];
+    for (uint32_t off = 0; off < LOG_BLOCK_SIZE; off += sizeof(chunk)) {
+        if (!flash.read(index * LOG_BLOCK_SIZE + off, chunk, sizeof(chunk))) return false;
+        if (memcmp(chunk, data + off, sizeof(chunk)) != 0) return false;
+    }
+    return true;
+}
+
+bool DataLog::commit() {
+    if (blockCount == 0) return false;
+    if (encoder.empty()) return true;
+    const uint8_t* data = encoder.finish();
+
+    bool ok = false;
+    for (int attempt = 0; attempt < 2 && !ok; attempt++) {
+        ok = writeBlock(nextBlock, data);
+        if (!ok) {
+            // Место испорчено (или не стёрто после сбоя) - дальше с начала следующего сектора
+            failureCount++;
+            nextBlock = (nextBlock / blocksPerSector + 1) * blocksPerSector % blockCount;
+        }
+    }
+    if (ok) {
+        nextBlock = (nextBlock + 1) % blockCount;
+        writeCount++;
+        frameCount += encoder.frames();
+        byteCount += encoder.used();
+    }
+    // Блок начинается заново в любом случае: неудачно записанные кадры теряются
+    encoder.start(++sequence, boot);
+    return ok;
+}
+
+DataLogStats DataLog::stats() const {
+    DataLogStats s;
+    s.blocks = blockCount;
+    s.sequence = sequence;
+    s.boot = boot;
+    s.writes = writeCount;
+    s.erases = eraseCount;
+    s.failures = failureCount;
+    s.frames = frameCount;
+    s.bytes = byteCount;
+    return s;
+}
@@ -0,0 +1,59 @@
+// DataLog.h
+#ifndef DATA_LOG_H
+#define DATA_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FlashRegion.h"
+#include "DataLogCodec.h"
+
+// Состояние кольца журнала.
+struct DataLogStats {
+    uint32_t blocks;        // Блоков в области
+    uint32_t sequence;      // Номер следующего записываемого блока
+    uint16_t boot;          // Номер текущего запуска
+    uint32_t writes;        // Записано блоков с момента begin()
+    uint32_t erases;        // Стёрто секторов с момента begin()
+    uint32_t failures;      // Блоков, не прошедших проверку после записи
+    uint32_t frames;        // Кадров в записанных блоках
+    uint32_t bytes;         // Занято этими кадрами в блоках (с заголовками)
+};
+
+// Кольцо блоков журнала температур во флеш (формат - DataLogCodec.h).
+// Кадры копятся в блоке в RAM, блок пишется целиком; при входе в очередной сектор он стирается,
+// т.е. новые данные вытесняют самые старые по одному сектору. Порядок блоков восстанавливается
+// по сквозному номеру sequence, поэтому после перезагрузки запись продолжается за новейшим блоком.
+class DataLog {
+public:
+    explicit DataLog(FlashRegion& flash);
+
+    // Поиск новейшего блока по заголовкам. false - в области нет ни одного целого сектора под блоки.
+    bool begin(uint8_t channels, uint16_t periodMs);
+    // Кадр в текущий блок. false - блок заполнен: нужен commit(), затем повтор.
+    bool append(const LogFrame& frame) { return encoder.append(frame); }
+    // Запись текущего блока (если в нём есть кадры) и начало нового. Неудачная запись
+    // переносит запись в следующий сектор и повторяется один раз.
+    bool commit();
+
+    // Кадров в ещё не записанном блоке.
+    uint16_t pendingFrames() const { return encoder.frames(); }
+    DataLogStats stats() const;
+
+private:
+    FlashRegion& flash;
+    LogEncoder encoder;
+    uint32_t blocksPerSector;
+    uint32_t blockCount;
+    uint32_t nextBlock;     // Куда писать следующий блок
+    uint32_t sequence;
+    uint16_t boot;
+    uint32_t writeCount;
+    uint32_t eraseCount;
+    uint32_t failureCount;
+    uint32_t frameCount;
+    uint32_t byteCount;
+
+    bool writeBlock(uint32_t index, const uint8_t* data);
+};
+
+#endif
@@ -0,0 +1,179 @@
+// DataLogCodec.cpp
+// Кодирование кадров журнала температур: ключевые кадры и разности в zig-zag varint.
+#include <string.h>
+#include "DataLogCodec.h"
+#include "Crc32.h"
+
+static const size_t HEADER_SIZE = sizeof(LogBlockHeader);
+
+static uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+static int32_t unzigzag(uint32_t v) { return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1); }
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+static size_t putSigned(uint8_t* out, int32_t v) { return putVarint(out, zigzag(v)); }
+
+// Чтение varint не дальше end. false - запись обрывается или длиннее 5 байт.
+static bool getVarint(const uint8_t* data, size_t& pos, size_t end, uint32_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 35 && pos < end; shift += 7) {
+        uint8_t b = data[pos++];
+        v |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool getSigned(const uint8_t* data, size_t& pos, size_t end, int32_t& v) {
+    uint32_t u;
+    if (!getVarint(data, pos, end, u)) return false;
+    v = unzigzag(u);
+    return true;
+}
+
+// CRC блока: заголовок без поля crc, затем записи
+static uint32_t blockCrc(const uint8_t* block, const LogBlockHeader& h) {
+    uint32_t crc = crc32(&h, offsetof(LogBlockHeader, crc));
+    return crc32(block + HEADER_SIZE, h.length, crc);
+}
+
+bool logBlockValid(const uint8_t* block, LogBlockHeader& header) {
+    memcpy(&header, block, sizeof(header));
+    if (header.magic != LOG_BLOCK_MAGIC || header.version != LOG_FORMAT_VERSION) return false;
+    if (header.channels == 0 || header.channels > LOG_MAX_CHANNELS) return false;
+    if (header.length > LOG_BLOCK_SIZE - HEADER_SIZE) return false;
+    return blockCrc(block, header) == header.crc;
+}
+
+LogEncoder::LogEncoder(uint8_t channels, uint16_t periodMs)
+    : channels(channels > LOG_MAX_CHANNELS ? LOG_MAX_CHANNELS : channels), periodMs(periodMs),
+      sequence(0), boot(0), pos(HEADER_SIZE), frameCount(0) {
+    memset(block, 0xFF, sizeof(block));
+    memset(&prev, 0, sizeof(prev));
+}
+
+void LogEncoder::start(uint32_t seq, uint16_t bootId) {
+    memset(block, 0xFF, sizeof(block));
+    sequence = seq;
+    boot = bootId;
+    pos = HEADER_SIZE;
+    frameCount = 0;
+}
+
+bool LogEncoder::append(const LogFrame& frame) {
+    uint8_t rec[logMaxRecordSize(LOG_MAX_CHANNELS)];
+    size_t n = 0;
+    uint32_t cycleDelta = frame.cycle - prev.cycle;
+
+    if (frameCount == 0 || cycleDelta == 0 || cycleDelta > LOG_MAX_CYCLE_DELTA) {
+        n += putVarint(rec + n, 1);
+        n += putVarint(rec + n, frame.cycle);
+        n += putVarint(rec + n, frame.timeMs);
+        for (uint8_t c = 0; c < channels; c++) {
+            const LogSample& s = frame.ch[c];
+            n += putSigned(rec + n, s.temp);
+            n += putSigned(rec + n, s.setpoint);
+            n += putVarint(rec + n, s.duty);
+            n += putVarint(rec + n, s.flags);
+        }
+    } else {
+        // Уставка и флаги меняются редко: пишутся только отмеченные в extra
+        uint32_t extra = 0;
+        for (uint8_t c = 0; c < channels; c++) {
+            if (frame.ch[c].setpoint != prev.ch[c].setpoint) extra |= 1UL << (2 * c);
+            if (frame.ch[c].flags != prev.ch[c].flags) extra |= 1UL << (2 * c + 1);
+        }
+        n += putVarint(rec + n, cycleDelta << 1);
+        n += putVarint(rec + n, extra);
+        for (uint8_t c = 0; c < channels; c++) {
+            const LogSample& s = frame.ch[c];
+            const LogSample& p = prev.ch[c];
+            n += putSigned(rec + n, static_cast<int32_t>(s.temp) - p.temp);
+            n += putSigned(rec + n, static_cast<int32_t>(s.duty) - p.duty);
+            if (extra & (1UL << (2 * c))) n += putSigned(rec + n, static_cast<int32_t>(s.setpoint) - p.setpoint);
+            if (extra & (1UL << (2 * c + 1))) n += putVarint(rec + n, s.flags);
+        }
+    }
+
+    if (pos + n > LOG_BLOCK_SIZE) return false;
+    memcpy(block + pos, rec, n);
+    pos += n;
+    frameCount++;
+    prev = frame;
+    return true;
+}
+
+const uint8_t* LogEncoder::finish() {
+    LogBlockHeader h;
+    h.magic = LOG_BLOCK_MAGIC;
+    h.version = LOG_FORMAT_VERSION;
+    h.channels = channels;
+    h.sequence = sequence;
+    h.boot = boot;
+    h.periodMs = periodMs;
+    h.length = static_cast<uint16_t>(pos - HEADER_SIZE);
+    h.frames = frameCount;
+    h.crc = blockCrc(block, h);
+    memcpy(block, &h, sizeof(h));
+    return block;
+}
+
+LogDecoder::LogDecoder(const uint8_t* block) : block(block), pos(HEADER_SIZE), end(HEADER_SIZE), havePrev(false) {
+    ok = logBlockValid(block, head);
+    if (ok) end = HEADER_SIZE + head.length;
+    memset(&prev, 0, sizeof(prev));
+}
+
+bool LogDecoder::next(LogFrame& frame) {
+    if (!ok || pos >= end) return false;
+    size_t p = pos;
+    uint32_t h;
+    if (!getVarint(block, p, end, h)) return false;
+
+    LogFrame f;
+    memset(&f, 0, sizeof(f));
+    if (h == 1) {
+        uint32_t v;
+        if (!getVarint(block, p, end, f.cycle) || !getVarint(block, p, end, f.timeMs)) return false;
+        for (uint8_t c = 0; c < head.channels; c++) {
+            int32_t temp, setpoint;
+            uint32_t duty;
+            if (!getSigned(block, p, end, temp) || !getSigned(block, p, end, setpoint) ||
+                !getVarint(block, p, end, duty) || !getVarint(block, p, end, v)) return false;
+            f.ch[c].temp = static_cast<int16_t>(temp);
+            f.ch[c].setpoint = static_cast<int16_t>(setpoint);
+            f.ch[c].duty = static_cast<uint8_t>(duty);
+            f.ch[c].flags = static_cast<uint8_t>(v);
+        }
+    } else {
+        uint32_t cycleDelta = h >> 1;
+        uint32_t extra;
+        if (!havePrev || (h & 1) || cycleDelta == 0 || !getVarint(block, p, end, extra)) return false;
+        f.cycle = prev.cycle + cycleDelta;
+        f.timeMs = prev.timeMs + cycleDelta * head.periodMs;
+        for (uint8_t c = 0; c < head.channels; c++) {
+            int32_t dTemp, dDuty, dSetpoint = 0;
+            uint32_t flags = prev.ch[c].flags;
+            if (!getSigned(block, p, end, dTemp) || !getSigned(block, p, end, dDuty)) return false;
+            if ((extra & (1UL << (2 * c))) && !getSigned(block, p, end, dSetpoint)) return false;
+            if ((extra & (1UL << (2 * c + 1))) && !getVarint(block, p, end, flags)) return false;
+            f.ch[c].temp = static_cast<int16_t>(prev.ch[c].temp + dTemp);
+            f.ch[c].setpoint = static_cast<int16_t>(prev.ch[c].setpoint + dSetpoint);
+            f.ch[c].duty = static_cast<uint8_t>(prev.ch[c].duty + dDuty);
+            f.ch[c].flags = static_cast<uint8_t>(flags);
+        }
+    }
+    pos = p;
+    prev = f;
+    havePrev = true;
+    frame = f;
+    return true;
+}
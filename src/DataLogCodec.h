@@ -0,0 +1,116 @@
+// DataLogCodec.h
+#ifndef DATA_LOG_CODEC_H
+#define DATA_LOG_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Формат журнала температур во флеш. Общий для прошивки и декодера на хосте (tools/datalog2csv.cpp),
+// поэтому без зависимостей от Arduino и Config.h.
+//
+// Журнал - последовательность блоков по LOG_BLOCK_SIZE байт: заголовок LogBlockHeader, затем записи кадров.
+// Первая запись блока - ключевой кадр (абсолютные значения), остальные - разности с предыдущим кадром
+// в zig-zag varint. Каждый блок декодируется независимо, повреждённый блок отбрасывается по CRC.
+//
+// Запись начинается с varint head:
+//   head = 1                  - ключевой кадр: varint cycle, varint timeMs, затем по каналам
+//                               svarint temp, svarint setpoint, varint duty, varint flags;
+//   head = cycleDelta << 1    - разностный кадр (cycleDelta 1..LOG_MAX_CYCLE_DELTA): varint extra,
+//                               затем по каналам svarint dTemp, svarint dDuty и, если в extra
+//                               взведён бит канала, svarint dSetpoint (бит 2*ch) и varint flags (бит 2*ch+1).
+// Время разностного кадра - время предыдущего плюс cycleDelta * periodMs.
+// head не превышает 127, поэтому первый байт записи никогда не 0xFF: 0xFF - стёртая флеш, конец записей.
+
+#define LOG_FORMAT_VERSION 1
+#define LOG_BLOCK_MAGIC 0x4C44          // "DL"
+#define LOG_BLOCK_SIZE 512              // Блок пишется во флеш целиком, одной операцией
+#define LOG_MAX_CHANNELS 8
+#define LOG_MAX_CYCLE_DELTA 63          // Больший пропуск циклов - ключевой кадр
+#define LOG_TEMP_INVALID INT16_MIN      // Датчик неисправен (NaN)
+#define LOG_TEMP_SCALE 10               // Температура и уставка - в 0.1 °C
+
+struct LogBlockHeader {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t channels;
+    uint32_t sequence;      // Номер блока, сквозной между перезагрузками
+    uint16_t boot;          // Номер запуска прошивки (растёт при каждом begin())
+    uint16_t periodMs;      // Период кадров
+    uint16_t length;        // Байт записей после заголовка
+    uint16_t frames;        // Кадров в блоке
+    uint32_t crc;           // CRC-32 заголовка (без поля crc) и записей
+};
+static_assert(sizeof(LogBlockHeader) == 20, "Заголовок блока журнала - 20 байт");
+
+// Один канал кадра в единицах журнала.
+struct LogSample {
+    int16_t temp;           // 0.1 °C, LOG_TEMP_INVALID - нет данных
+    int16_t setpoint;       // 0.1 °C
+    uint8_t duty;           // 0..255
+    uint8_t flags;          // CHANNEL_FLAG_*
+};
+
+// Кадр журнала: состояние всех каналов на конец цикла управления.
+struct LogFrame {
+    uint32_t cycle;
+    uint32_t timeMs;
+    LogSample ch[LOG_MAX_CHANNELS];
+};
+
+// Сборка блока в буфере LOG_BLOCK_SIZE байт.
+class LogEncoder {
+public:
+    LogEncoder(uint8_t channels, uint16_t periodMs);
+
+    // Новый блок: следующий кадр будет ключевым.
+    void start(uint32_t sequence, uint16_t boot);
+    // Добавление кадра. false - кадр в блок не помещается (блок нужно записать и начать новый).
+    bool append(const LogFrame& frame);
+    // Заполнение заголовка и CRC; хвост блока остаётся 0xFF. Возвращает готовый блок.
+    const uint8_t* finish();
+
+    uint16_t frames() const { return frameCount; }
+    size_t used() const { return pos; }
+    bool empty() const { return frameCount == 0; }
+
+private:
+    uint8_t block[LOG_BLOCK_SIZE];
+    uint8_t channels;
+    uint16_t periodMs;
+    uint32_t sequence;
+    uint16_t boot;
+    size_t pos;
+    uint16_t frameCount;
+    LogFrame prev;
+};
+
+// Разбор одного блока.
+class LogDecoder {
+public:
+    // block - LOG_BLOCK_SIZE байт. valid() - заголовок и CRC в порядке.
+    explicit LogDecoder(const uint8_t* block);
+
+    bool valid() const { return ok; }
+    const LogBlockHeader& header() const { return head; }
+    // Следующий кадр блока. false - кадры кончились (или запись повреждена).
+    bool next(LogFrame& frame);
+
+private:
+    const uint8_t* block;
+    LogBlockHeader head;
+    bool ok;
+    size_t pos;
+    size_t end;
+    bool havePrev;
+    LogFrame prev;
+};
+
+// Проверка заголовка и CRC блока без разбора записей.
+bool logBlockValid(const uint8_t* block, LogBlockHeader& header);
+
+// Оценка наибольшей длины записи кадра для channels каналов.
+constexpr size_t logMaxRecordSize(uint8_t channels) {
+    return 1 + 5 + 5 + channels * (3 + 3 + 2 + 2);
+}
+
+#endif
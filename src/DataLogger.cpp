@@ -0,0 +1,104 @@
+// DataLogger.cpp
+// Задача журнала температур: снимки задачи управления -> кадры DataLog -> блоки во флеш.
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "DataLogger.h"
+#include "DataLog.h"
+#include "FlashRegion.h"
+#include "Config.h"
+
+static_assert(NUM_CHANNELS <= LOG_MAX_CHANNELS, "Каналов больше, чем помещается в кадр журнала");
+
+static PartitionFlash logFlash(LOG_PARTITION_LABEL);
+static DataLog dataLog(logFlash);
+static QueueHandle_t logQueue = NULL;
+static std::atomic<uint32_t> queuedFrames{0};
+static std::atomic<uint32_t> droppedFrames{0};
+static std::atomic<uint32_t> maxCommitUs{0};
+// Состояние кольца для reportDataLogStats(); пишет только задача журнала
+static SeqLock<DataLogStats> logState;
+
+// Температура и уставка в 0.1 °C с насыщением в int16
+static int16_t toLogUnits(float value) {
+    if (isnan(value)) return LOG_TEMP_INVALID;
+    long v = lroundf(value * LOG_TEMP_SCALE);
+    if (v <= INT16_MIN) return INT16_MIN + 1;
+    if (v > INT16_MAX) return INT16_MAX;
+    return static_cast<int16_t>(v);
+}
+
+static void toFrame(const SystemSnapshot& snap, LogFrame& frame) {
+    frame.cycle = snap.cycle;
+    frame.timeMs = snap.tick * portTICK_PERIOD_MS;
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        const ChannelState& st = snap.channels[i];
+        frame.ch[i].temp = toLogUnits(st.temperature);
+        frame.ch[i].setpoint = toLogUnits(st.setpoint);
+        frame.ch[i].duty = static_cast<uint8_t>(constrain(st.output, 0, 255));
+        frame.ch[i].flags = st.flags;
+    }
+}
+
+static void TaskDataLogger(void *pvParameters) {
+    SystemSnapshot snap;
+    LogFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    while (1) {
+        if (xQueueReceive(logQueue, &snap, portMAX_DELAY) != pdTRUE) continue;
+        toFrame(snap, frame);
+        if (dataLog.append(frame)) continue;
+
+        // Блок заполнен: запись (и стирание сектора при входе в него) - в окне простоя задачи управления.
+        // Пока ждём и пишем, снимки копятся в очереди. Стирание останавливает оба ядра дольше срока
+        // controlWatchdog - на время операции PartitionFlash приостанавливает надзор (CONTROL_WATCHDOG_FLASH_MAX_MS).
+        waitNextPublish(pdMS_TO_TICKS(2 * CONTROL_PERIOD_MS));
+        uint32_t start = micros();
+        dataLog.commit();
+        uint32_t elapsed = micros() - start;
+        if (elapsed > maxCommitUs.load()) maxCommitUs.store(elapsed);
+        logState.write(dataLog.stats());
+        dataLog.append(frame);
+    }
+}
+
+void beginDataLogger() {
+    if (!logFlash.begin() || !dataLog.begin(NUM_CHANNELS, CONTROL_PERIOD_MS)) {
+        Serial.println("[LOG] Раздел журнала не найден, журнал температур отключён");
+        return;
+    }
+    DataLogStats st = dataLog.stats();
+    logState.write(st);
+    Serial.printf("[LOG] Журнал: %u блоков по %u байт, запуск %u, следующий блок %u\n",
+                  st.blocks, LOG_BLOCK_SIZE, st.boot, st.sequence);
+
+    logQueue = xQueueCreate(LOG_QUEUE_LENGTH, sizeof(SystemSnapshot));
+    xTaskCreatePinnedToCore(TaskDataLogger, "DataLog", 3072, NULL, LOG_TASK_PRIORITY, NULL, UI_TASK_CORE);
+}
+
+void logSnapshot(const SystemSnapshot& snap) {
+    if (!logQueue) return;
+    if (xQueueSend(logQueue, &snap, 0) == pdTRUE) queuedFrames++;
+    else droppedFrames++;
+}
+
+void reportDataLogStats() {
+    DataLogStats s;
+    if (!logQueue || !logState.read(s)) return;
+    uint32_t queued = queuedFrames.exchange(0);
+    uint32_t dropped = droppedFrames.exchange(0);
+    if (s.frames == 0) {
+        Serial.printf("[LOG] кадров %u (потеряно %u), блоков ещё не записано\n", queued, dropped);
+        return;
+    }
+    // Глубина кольца при текущей плотности кадров
+    float bytesPerFrame = static_cast<float>(s.bytes) / s.frames;
+    float hours = s.blocks * (static_cast<float>(s.frames) / s.writes) * CONTROL_PERIOD_MS / 3600000.0f;
+    Serial.printf("[LOG] кадров %u (потеряно %u), блоков %u (ошибок %u, стираний %u), %.1f байт/кадр, "
+                  "кольцо ~%.1f ч, запись блока макс %u мкс\n",
+                  queued, dropped, s.writes, s.failures, s.erases, bytesPerFrame, hours, maxCommitUs.exchange(0));
+}
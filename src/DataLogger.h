@@ -0,0 +1,18 @@
+// DataLogger.h
+#ifndef DATA_LOGGER_H
+#define DATA_LOGGER_H
+
+#include <Arduino.h>
+#include "ChannelState.h"
+
+// Журнал температур: каждый снимок задачи управления (температура, уставка, скважность по каналам)
+// кодируется в блоки DataLog и пишется в раздел LOG_PARTITION_LABEL. Кодирование и запись - в своей
+// задаче; задача управления только кладёт снимок в очередь. Выгрузка и разбор: tools/datalog2csv.cpp.
+void beginDataLogger();
+// Снимок в очередь журнала; не блокирует. Вызывается писателем systemState (задача управления).
+// При переполнении очереди кадр теряется и учитывается в статистике.
+void logSnapshot(const SystemSnapshot& snap);
+// Статистика журнала в Serial: кадры, потери, байт на кадр, оценка глубины кольца.
+void reportDataLogStats();
+
+#endif
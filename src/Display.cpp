@@ -5,20 +5,34 @@
 // Четвёртая строка используется для отображения режима работы системы.
 #include "Display.h"
 #include "Globals.h"
+#include "TextFormat.h"
+#include "LcdFrameBuffer.h"
 #include <Arduino.h>
+#include <Wire.h>
+#include <atomic>
 
 // Инициализация объекта дисплея с I2C-адресом 0x27
 LiquidCrystal_PCF8574 lcd(0x27);
+// Теневой буфер экрана: отрисовка идёт в него, на дисплей уходят только изменения
+static LcdFrameBuffer frameBuffer(lcd);
+
+static TaskHandle_t displayTask = NULL;
+static std::atomic<uint32_t> displayWakeups{0};  // Пробуждений задачи дисплея (для reportDisplayStats)
+// Видимое содержимое последнего снимка, о котором задача дисплея уже уведомлена (только задача управления)
+static SystemSnapshot notifiedState;
+static bool notifiedValid = false;
 
 // Инициализация дисплея: очищаем экраны
 void initDisplay() {
     if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100))) {
+        Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);  // Повторный Wire.begin() внутри lcd.begin() пины не меняет
         lcd.begin(DISPLAY_WIDTH, DISPLAY_HEIGHT);
-        // Заполняем все строки 20 пробелами для очистки
-        for (uint8_t row = 0; row < DISPLAY_HEIGHT; row++) {
-            lcd.setCursor(0, row);
-            lcd.print("                    ");
-        }
+        Wire.setClock(LCD_I2C_CLOCK_HZ);
+        lcd.setBusClock(LCD_I2C_CLOCK_HZ);
+        // Содержимое дисплея неизвестно: полная перерисовка пробелами
+        frameBuffer.fill(' ');
+        frameBuffer.invalidate();
+        frameBuffer.flush();
         xSemaphoreGive(displayMutex);
     } else {
         Serial.println("[DISPLAY] Не удалось захватить мьютекс для инициализации!");
@@ -26,103 +40,212 @@ void initDisplay() {
 }
 
 // Обновление строки для одного канала по формату: "Tn:XXXC°SP:XXXC°PPP%"
-// Пример: "T1:025C°SP:100C°100%"
-void updateChannelDisplay(uint8_t channel) {
-    // Получаем текущую температуру и уставку как целые значения
-    int currentTemp = static_cast<int>(channels[channel]->getTemperature());
-    int currentSet = static_cast<int>(channels[channel]->getSetpoint());
-    // Расчет мощности: процент от максимальной мощности
-    int out = channels[channel]->getOutput();
-    int percent = (out * 100) / PWM_MAX_DUTY;
-    
-    char buffer[21]; // 20 символов + нулевой терминатор
-    // Формат: "T%d:%03dC°SP:%03dC°%3d%%"
-    // %03d – выводит число в 3 символа с ведущими нулями.
-    // %3d – выводит число с правым выравниванием в 3 символа.
-    snprintf(buffer, sizeof(buffer), "T%d:%03dC°SP:%03dC°%3d%%", channel + 1, currentTemp, currentSet, percent);
-    
-    // Выводим строку для данного канала на дисплее
-    lcd.setCursor(0, channel);
-    lcd.print(buffer);
-}
-
-// Формирование строки для отображения режима работы.
-// Формат: "****<MODE> MODE<extraStars>"
-// Общая длина строки – 20 символов.
-String formatModeString(SystemMode mode) {
-    char modeStr[16];
-    switch (mode) {
-       case STANDBY_MODE:     strcpy(modeStr, "STANDBY");     break;
-       case WORKING_MODE:     strcpy(modeStr, "WORKING");     break;
-       case SETTING_MODE:     strcpy(modeStr, "SETTING");     break;
-       case CALIBRATION_MODE: strcpy(modeStr, "CALIBRATION"); break;
-       case AUTOTUNE_MODE:    strcpy(modeStr, "AUTOTUNE");    break;
-       case MANUAL_MODE:      strcpy(modeStr, "MANUAL");      break;
-       default:               strcpy(modeStr, "UNKNOWN");     break;
-    }
-    int lenMode = strlen(modeStr);
-    // Формат: 4 символа звезд + длина modeStr + 5 символов " MODE" = 4 + lenMode + 5 = (lenMode + 9)
-    int extraStars = 20 - (lenMode + 9);
-    if (extraStars < 0) extraStars = 0;
-    
-    char extra[12];
-    for (int i = 0; i < extraStars; i++) {
-        extra[i] = '*';
-    }
-    extra[extraStars] = '\0';
-    
-    char fullBuffer[21];
-    snprintf(fullBuffer, sizeof(fullBuffer), "****%s MODE%s", modeStr, extra);
-    return String(fullBuffer);
+// Пример: "T1:025C°SP:100C°100%" (° - символ LCD_DEGREE знакогенератора)
+// Данные берутся из снимка состояния канала; при неисправности датчика вместо температуры - "---".
+void updateChannelDisplay(uint8_t channel, const ChannelState& state) {
+    // Расчет мощности: процент от максимальной мощности (фактически поданной)
+    int percent = (state.output * 100) / PWM_MAX_DUTY;
+
+    char buffer[DISPLAY_WIDTH + 1];
+    TextWriter line(buffer, sizeof(buffer));
+    line.chr('T').u(channel + 1).chr(':');
+    if (state.flags & CHANNEL_FLAG_SENSOR_FAULT) line.str("---");
+    else line.i(static_cast<int32_t>(state.temperature), 3, '0');
+    line.chr('C').chr(LCD_DEGREE).str("SP:").i(static_cast<int32_t>(state.setpoint), 3, '0')
+        .chr('C').chr(LCD_DEGREE).i(percent, 3).chr('%').padTo(DISPLAY_WIDTH);
+
+    // Строка канала - в теневой буфер, на дисплей уйдут только изменившиеся символы
+    frameBuffer.writeLine(channel, line.c_str());
+}
+
+// Строки режима работы для 4-й строки дисплея, по одной на SystemMode.
+// Формат: "****<MODE> MODE<extraStars>", общая длина строки – 20 символов.
+static constexpr const char* MODE_LINES[] = {
+    "****STANDBY MODE****",      // STANDBY_MODE
+    "****WORKING MODE****",      // WORKING_MODE
+    "****SETTING MODE****",      // SETTING_MODE
+    "****CALIBRATION MODE",      // CALIBRATION_MODE
+    "****AUTOTUNE MODE***",      // AUTOTUNE_MODE
+    "****MANUAL MODE*****",      // MANUAL_MODE
+};
+static constexpr const char* MODE_LINE_UNKNOWN = "****UNKNOWN MODE****";
+
+// Проверка длины всех строк режима на этапе компиляции.
+static constexpr bool modeLinesValid(size_t i = 0) {
+    return i >= sizeof(MODE_LINES) / sizeof(MODE_LINES[0]) ||
+           (constStrLen(MODE_LINES[i]) == DISPLAY_WIDTH && modeLinesValid(i + 1));
+}
+static_assert(sizeof(MODE_LINES) / sizeof(MODE_LINES[0]) == MANUAL_MODE + 1, "Строка режима на каждый SystemMode");
+static_assert(modeLinesValid() && constStrLen(MODE_LINE_UNKNOWN) == DISPLAY_WIDTH, "Строки режима - ровно DISPLAY_WIDTH символов");
+
+// Строка для отображения режима работы (из таблицы, без форматирования).
+const char* formatModeString(SystemMode mode) {
+    if (mode < 0 || mode > MANUAL_MODE) return MODE_LINE_UNKNOWN;
+    return MODE_LINES[mode];
+}
+
+// Мигание уставки редактируемого канала: фаза по часам, период DISPLAY_BLINK_MS.
+static bool blinkPhase() {
+    return (millis() / DISPLAY_BLINK_MS) & 1;
+}
+
+// Канал, уставка которого сейчас редактируется (-1 - нет).
+static int blinkingChannel(const SystemSnapshot& snap) {
+    return (snap.mode == WORKING_MODE && settingModeActive) ? activeChannel : -1;
 }
 
 // Обновление дисплея: обновляются первые три строки для каналов и четвёртая строка для режима.
+// Состояние берётся из снимка задачи управления (systemState) без захвата systemMutex.
+// Кадр целиком рисуется в теневой буфер; отбор изменений делает flush().
 void updateDisplay() {
-    static int lastTemps[NUM_CHANNELS] = {0};
-    static int lastSetpoints[NUM_CHANNELS] = {0};
-    
+    SystemSnapshot snap = readSystemState();
+    int blinking = blinkingChannel(snap);
+
     if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50))) {
-        // Обновляем данные для каждого канала
-        for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
-            if (!channels[i]) continue;
-            int currentTemp = static_cast<int>(channels[i]->getTemperature());
-            int currentSet = static_cast<int>(channels[i]->getSetpoint());
-            if (abs(currentTemp - lastTemps[i]) >= 1 || currentSet != lastSetpoints[i]) {
-                updateChannelDisplay(i);
-                lastTemps[i] = currentTemp;
-                lastSetpoints[i] = currentSet;
-            }
+        // Данные каждого канала, помещающегося над строкой режима
+        for (uint8_t i = 0; i < NUM_CHANNELS && i < DISPLAY_HEIGHT - 1; i++) {
+            if (i == blinking) blinkSetpoint(i, snap.channels[i]);
+            else updateChannelDisplay(i, snap.channels[i]);
         }
-        // Обновляем режим работы на 4-й строке
-        String modeStr = formatModeString(systemMode);
-        char modeLine[DISPLAY_WIDTH + 1];
-        strncpy(modeLine, modeStr.c_str(), DISPLAY_WIDTH);
-        modeLine[DISPLAY_WIDTH] = '\0';
-        lcd.setCursor(0, DISPLAY_HEIGHT - 1);
-        lcd.print(modeLine);
+        // Режим работы на 4-й строке
+        frameBuffer.writeLine(DISPLAY_HEIGHT - 1, formatModeString(snap.mode));
+        frameBuffer.flush();
         xSemaphoreGive(displayMutex);
     } else {
         Serial.println("[DISPLAY] Не удалось захватить мьютекс для обновления!");
     }
 }
 
-// Функция мигания для режима настройки для активного канала.
-// Если требуется показывать мигание вместо постоянного вывода текущих значений.
-void blinkSetpoint(int channel) {
-    static unsigned long lastBlinkTime = 0;
-    static bool blinkState = false;
-    unsigned long currentMillis = millis();
-    if (currentMillis - lastBlinkTime > 500) {
-        blinkState = !blinkState;
-        lastBlinkTime = currentMillis;
-    }
-    if (blinkState) {
-        char buffer[21];
-        // Выводим заполнители вместо значения, например:
-        snprintf(buffer, sizeof(buffer), "T%d:___C SP:___C ___%%", channel + 1);
-        lcd.setCursor(0, channel);
-        lcd.print(buffer);
+// Функция мигания для режима настройки для активного канала:
+// в одной фазе - заполнители вместо значений, в другой - обычная строка канала.
+// Пишет в теневой буфер; на дисплей строка попадёт при flush() в updateDisplay().
+void blinkSetpoint(uint8_t channel, const ChannelState& state) {
+    if (blinkPhase()) {
+        char buffer[DISPLAY_WIDTH + 1];
+        // Выводим заполнители вместо значения: "Tn:___C SP:___C ___%"
+        TextWriter line(buffer, sizeof(buffer));
+        line.chr('T').u(channel + 1).str(":___C SP:___C ___%").padTo(DISPLAY_WIDTH);
+        frameBuffer.writeLine(channel, line.c_str());
     } else {
-        updateChannelDisplay(channel);
+        updateChannelDisplay(channel, state);
+    }
+}
+
+// Задача дисплея: спит до уведомления (notifyDisplay) и рисует кадр не чаще раза в DISPLAY_MIN_FRAME_MS;
+// уведомления, пришедшие за это время, объединяются в один кадр. Сама просыпается только
+// для мигания уставки в режиме её настройки. Обмен по I2C идёт только в этой задаче.
+static void TaskUpdateDisplay(void *pvParameters) {
+    const TickType_t minFrame = pdMS_TO_TICKS(DISPLAY_MIN_FRAME_MS);
+    TickType_t lastFrame = xTaskGetTickCount() - minFrame;
+
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (blinkingChannel(readSystemState()) >= 0) {
+            wait = pdMS_TO_TICKS(DISPLAY_BLINK_MS - millis() % DISPLAY_BLINK_MS) + 1;
+        }
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, wait);
+        displayWakeups++;
+
+        TickType_t elapsed = xTaskGetTickCount() - lastFrame;
+        if (elapsed < minFrame) {
+            vTaskDelay(minFrame - elapsed);
+            // Всё, что пришло за паузу, войдёт в этот же кадр
+            xTaskNotifyWait(0, UINT32_MAX, &events, 0);
+        }
+        lastFrame = xTaskGetTickCount();
+        updateDisplay();
+    }
+}
+
+void beginDisplayTask() {
+    xTaskCreatePinnedToCore(TaskUpdateDisplay, "Display", 2560, NULL, DISPLAY_TASK_PRIORITY, &displayTask, UI_TASK_CORE);
+    notifyDisplay(DISPLAY_EVENT_STATE);  // Первый кадр
+}
+
+void notifyDisplay(uint32_t events) {
+    if (displayTask) xTaskNotify(displayTask, events, eSetBits);
+}
+
+// Поля снимка, видимые на дисплее, в тех же единицах, что и при выводе строки канала.
+static bool sameOnScreen(const ChannelState& a, const ChannelState& b) {
+    bool faultA = a.flags & CHANNEL_FLAG_SENSOR_FAULT;
+    bool faultB = b.flags & CHANNEL_FLAG_SENSOR_FAULT;
+    if (faultA != faultB) return false;
+    if (!faultA && static_cast<int32_t>(a.temperature) != static_cast<int32_t>(b.temperature)) return false;
+    return static_cast<int32_t>(a.setpoint) == static_cast<int32_t>(b.setpoint) &&
+           (a.output * 100) / PWM_MAX_DUTY == (b.output * 100) / PWM_MAX_DUTY;
+}
+
+void notifyDisplayState(const SystemSnapshot& snap) {
+    bool changed = !notifiedValid || snap.mode != notifiedState.mode;
+    for (uint8_t i = 0; i < NUM_CHANNELS && !changed; i++) {
+        changed = !sameOnScreen(snap.channels[i], notifiedState.channels[i]);
+    }
+    if (!changed) return;
+    notifiedState = snap;
+    notifiedValid = true;
+    notifyDisplay(DISPLAY_EVENT_STATE);
+}
+
+// Вывод статистики обмена с дисплеем в Serial с обнулением.
+// Байты - байты HD44780 (символы и команды курсора). На шине каждый байт HD44780 - 4 байта PCF8574
+// (два полубайта со стробом E) плюс адрес на каждую транзакцию: setCursor идёт отдельно,
+// символы отрезка - одной транзакцией через writeBuffer().
+void reportDisplayStats() {
+    if (!xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50))) return;
+    LcdFrameStats s = frameBuffer.stats(true);
+    xSemaphoreGive(displayMutex);
+    uint32_t wakeups = displayWakeups.exchange(0);
+    if (s.frames == 0) {
+        Serial.printf("[DISPLAY] Изменений на дисплее не было (пробуждений %u)\n", wakeups);
+        return;
+    }
+    uint32_t full = DISPLAY_HEIGHT * (DISPLAY_WIDTH + 1);
+    Serial.printf("[DISPLAY] пробуждений %u, кадров %u, байт/кадр ср %u / макс %u (полная перерисовка %u), I2C %u байт/кадр\n",
+                  wakeups, s.frames, s.totalBytes / s.frames, s.maxBytes, full, s.wireBytes / s.frames);
+}
+
+#ifdef LCD_BENCHMARK
+// Полная перерисовка экрана: посимвольно (транзакция I2C на каждый символ) или строками через writeBuffer().
+static void refreshScreen(const uint8_t* text, bool batched) {
+    for (uint8_t row = 0; row < DISPLAY_HEIGHT; row++) {
+        lcd.setCursor(0, row);
+        if (batched) {
+            lcd.writeBuffer(text, DISPLAY_WIDTH);
+        } else {
+            for (uint8_t col = 0; col < DISPLAY_WIDTH; col++) lcd.write(text[col]);
+        }
+    }
+}
+
+void benchmarkDisplay(int iterations) {
+    static const uint32_t clocks[] = {100000, 400000};
+    uint8_t text[DISPLAY_WIDTH];
+    for (uint8_t col = 0; col < DISPLAY_WIDTH; col++) text[col] = '0' + col % 10;
+
+    if (!xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100))) return;
+    for (uint8_t k = 0; k < sizeof(clocks) / sizeof(clocks[0]); k++) {
+        Wire.setClock(clocks[k]);
+        lcd.setBusClock(clocks[k]);
+
+        unsigned long start = micros();
+        for (int i = 0; i < iterations; i++) refreshScreen(text, false);
+        unsigned long perCharTime = micros() - start;
+
+        start = micros();
+        for (int i = 0; i < iterations; i++) refreshScreen(text, true);
+        unsigned long batchedTime = micros() - start;
+
+        Serial.printf("[BENCH] LCD %u кГц: посимвольно %.0f мкс/экран, writeBuffer %.0f мкс/экран (x%.1f)\n",
+                      clocks[k] / 1000, (float)perCharTime / iterations, (float)batchedTime / iterations,
+                      (float)perCharTime / batchedTime);
     }
+    Wire.setClock(LCD_I2C_CLOCK_HZ);
+    lcd.setBusClock(LCD_I2C_CLOCK_HZ);
+    // Вернуть на экран содержимое буфера
+    frameBuffer.invalidate();
+    frameBuffer.flush();
+    xSemaphoreGive(displayMutex);
 }
+#endif
@@ -7,12 +7,32 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include "Globals.h"
+#include "ChannelState.h"
+
+// Причины перерисовки - биты уведомления задачи дисплея
+#define DISPLAY_EVENT_STATE 0x01  // Изменились видимые на дисплее поля снимка состояния
+#define DISPLAY_EVENT_INPUT 0x02  // Действие оператора (начало/конец настройки уставки)
 
 // Функции для работы с дисплеем
 void initDisplay();
 void updateDisplay();
-void updateChannelDisplay(uint8_t channel);
-void blinkSetpoint(int channel);
+void updateChannelDisplay(uint8_t channel, const ChannelState& state);
+void blinkSetpoint(uint8_t channel, const ChannelState& state);
+// Задача дисплея: рисует кадр только по уведомлению, не чаще DISPLAY_MIN_FRAME_MS
+void beginDisplayTask();
+// Запрос перерисовки (DISPLAY_EVENT_*); не блокирует, из задач
+void notifyDisplay(uint32_t events);
+// Уведомление задачи дисплея, если новый снимок отличается от показанного в видимых полях
+// (целые градусы, проценты мощности, режим). Вызывается писателем systemState.
+void notifyDisplayState(const SystemSnapshot& snap);
+// Статистика байт на кадр в Serial (с обнулением)
+void reportDisplayStats();
+#ifdef LCD_BENCHMARK
+// Замер полной перерисовки экрана на 100 и 400 кГц: посимвольно и через writeBuffer (вывод в Serial).
+void benchmarkDisplay(int iterations);
+#endif
+// Строка режима работы (DISPLAY_WIDTH символов, статическая)
+const char* formatModeString(SystemMode mode);
 
 // Внешнее объявление объекта дисплея
 extern LiquidCrystal_PCF8574 lcd;
@@ -1,86 +1,186 @@
 // EEPROMHandler.cpp
-// Модуль для работы с EEPROM: сохранение и загрузка настроек, калибровочных смещений.
+// Модуль хранения настроек: конфигурация каналов (ConfigBlob - уставки, калибровка, PID, пределы)
+// - записи журнала во флеш. Каждое сохранение дописывает полный снимок; стирания распределяются по секторам.
+// Значения из прежней эмулированной EEPROM переносятся в журнал один раз, при первом запуске.
 #include <Arduino.h>
+#include <EEPROM.h>
+#include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
 #include "EEPROMHandler.h"
 #include "Globals.h"
+#include "ChannelTable.h"
+#include "FlashRegion.h"
+#include "SettingsJournal.h"
+#include "ConfigSchema.h"
 
-#define EEPROM_SETPOINT_ADDR (NUM_CHANNELS * sizeof(double))
-#define EEPROM_SIZE (NUM_CHANNELS * sizeof(double) * 2)
+// Прежняя раскладка EEPROM: смещения калибровки с адреса 0, за ними уставки (double на канал)
+#define LEGACY_CALIB_OFFSET_ADDR 0
+#define LEGACY_SETPOINT_ADDR (NUM_CHANNELS * sizeof(double))
+#define LEGACY_EEPROM_SIZE (NUM_CHANNELS * sizeof(double) * 2)
 
-static double prevSetpoints[NUM_CHANNELS] = {0}; // Предыдущие значения уставок
-SemaphoreHandle_t eepromMutex = NULL;            // Мьютекс для доступа к EEPROM
+static PartitionFlash settingsFlash(SETTINGS_PARTITION_LABEL);
+static SettingsJournal journal(settingsFlash);
+static bool journalReady = false;
+static ConfigBlob lastSaved;             // Последний записанный (или загруженный) снимок
+static bool lastSavedValid = false;
+static SemaphoreHandle_t settingsMutex = NULL;  // Доступ к журналу
 
-void initEEPROM() {
-    if (eepromMutex == NULL) {
-        eepromMutex = xSemaphoreCreateMutex();
+// Чтение прежней раскладки EEPROM поверх значений по умолчанию.
+// false - там нет корректных уставок (чистая или чужая EEPROM).
+static bool loadLegacyEEPROM(ConfigBlob& blob) {
+    if (!EEPROM.begin(LEGACY_EEPROM_SIZE)) return false;
+    configDefaults(blob);
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        double setpoint, offset;
+        EEPROM.get(LEGACY_SETPOINT_ADDR + i * sizeof(double), setpoint);
+        EEPROM.get(LEGACY_CALIB_OFFSET_ADDR + i * sizeof(double), offset);
+        if (isnan(setpoint) || setpoint < MIN_SETPOINT || setpoint > MAX_SETPOINT) return false;
+        blob.channels[i].setpoint = static_cast<float>(setpoint);
+        blob.channels[i].calibrationOffset = static_cast<float>(offset);
     }
-    EEPROM.begin(EEPROM_SIZE);
+    configValidate(blob);
+    return true;
 }
 
-void saveSettings() {
-    if (!eepromMutex || !xSemaphoreTake(eepromMutex, pdMS_TO_TICKS(100))) {
-        Serial.println("[EEPROM] Не удалось захватить мьютекс для сохранения!");
-        return;
+// Снимок конфигурации каналов; вызывается под systemMutex.
+static void captureConfig(ConfigBlob& blob) {
+    configDefaults(blob);
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        if (!channels[i]) continue;
+        ChannelConfig& cfg = blob.channels[i];
+        PIDBank::Channel& pid = channels[i]->getPID();
+        cfg.setpoint = channels[i]->getSetpoint();
+        cfg.calibrationOffset = channels[i]->getCalibrationOffset();
+        cfg.kp = pid.getKp();
+        cfg.ki = pid.getKi();
+        cfg.kd = pid.getKd();
+        cfg.minSetpoint = channels[i]->getMinSetpoint();
+        cfg.maxSetpoint = channels[i]->getMaxSetpoint();
+        cfg.maxOutput = pid.getMaxOutput();
+        cfg.pidFlags = (pid.getDirection() ? CONFIG_PID_REVERSE : 0) | (pid.getMode() ? CONFIG_PID_ON_RATE : 0);
     }
-    bool needUpdate = false;
+}
+
+// Применение проверенной конфигурации к каналам.
+static void applyConfig(const ConfigBlob& blob) {
     for (int i = 0; i < NUM_CHANNELS; i++) {
-        if (channels[i]) {
-            double currentSetpoint = channels[i]->getSetpoint();
-            if (fabs(currentSetpoint - prevSetpoints[i]) > 0.01) {
-                EEPROM.put(EEPROM_SETPOINT_ADDR + i * sizeof(double), currentSetpoint);
-                prevSetpoints[i] = currentSetpoint;
-                needUpdate = true;
-            }
-        }
+        if (!channels[i]) continue;
+        const ChannelConfig& cfg = blob.channels[i];
+        PIDBank::Channel& pid = channels[i]->getPID();
+        channels[i]->setSetpointLimits(cfg.minSetpoint, cfg.maxSetpoint);
+        channels[i]->setSetpoint(cfg.setpoint);
+        channels[i]->setCalibrationOffset(cfg.calibrationOffset);
+        pid.setTunings(cfg.kp, cfg.ki, cfg.kd);
+        pid.setLimits(0, static_cast<int16_t>(cfg.maxOutput));
+        pid.setDirection(cfg.pidFlags & CONFIG_PID_REVERSE);
+        pid.setMode(cfg.pidFlags & CONFIG_PID_ON_RATE);
     }
-    if (needUpdate) {
-        if (!EEPROM.commit()) {
-            Serial.println("[EEPROM] Ошибка записи данных!");
-        } else {
-            Serial.println("[EEPROM] Настройки сохранены");
-        }
+}
+
+// Запись снимка в журнал; вызывается под settingsMutex.
+static bool appendConfig(const ConfigBlob& blob) {
+    if (!journal.append(CONFIG_RECORD_TAG, &blob, sizeof(blob))) {
+        Serial.println("[SETTINGS] Ошибка записи журнала!");
+        return false;
+    }
+    lastSaved = blob;
+    lastSavedValid = true;
+    JournalStats st = journal.stats();
+    Serial.printf("[SETTINGS] Настройки сохранены: сектор %u (поколение %u), занято %u/%u байт\n",
+                  st.sector, st.generation, st.used, st.capacity);
+    return true;
+}
+
+void initSettingsStore() {
+    if (settingsMutex == NULL) {
+        settingsMutex = xSemaphoreCreateMutex();
+    }
+    journalReady = settingsFlash.begin() && journal.begin();
+    if (!journalReady) {
+        Serial.println("[SETTINGS] Журнал настроек недоступен, изменения не будут сохраняться");
+        return;
+    }
+    JournalStats st = journal.stats();
+    Serial.printf("[SETTINGS] Журнал: %u секторов, активный %u (поколение %u), занято %u/%u байт\n",
+                  settingsFlash.sectorCount(), st.sector, st.generation, st.used, st.capacity);
+}
+
+bool saveSettings() {
+    if (!journalReady) return false;
+
+    // Снимок настроек - под systemMutex, запись во флеш - уже без него
+    ConfigBlob blob;
+    if (!xSemaphoreTake(systemMutex, pdMS_TO_TICKS(100))) {
+        Serial.println("[SETTINGS] Не удалось захватить мьютекс системы для сохранения!");
+        return false;
+    }
+    captureConfig(blob);
+    xSemaphoreGive(systemMutex);
+
+    if (!settingsMutex || !xSemaphoreTake(settingsMutex, pdMS_TO_TICKS(100))) {
+        Serial.println("[SETTINGS] Не удалось захватить мьютекс для сохранения!");
+        return false;
+    }
+    bool written = false;
+    if (!lastSavedValid || memcmp(&blob, &lastSaved, sizeof(blob)) != 0) {
+        written = appendConfig(blob);
     }
-    xSemaphoreGive(eepromMutex);
+    xSemaphoreGive(settingsMutex);
+    return written;
 }
 
 void loadSettings() {
-    if (!eepromMutex || !xSemaphoreTake(eepromMutex, pdMS_TO_TICKS(100))) {
-        Serial.println("[EEPROM] Не удалось захватить мьютекс для загрузки!");
+    if (!settingsMutex || !xSemaphoreTake(settingsMutex, pdMS_TO_TICKS(100))) {
+        Serial.println("[SETTINGS] Не удалось захватить мьютекс для загрузки!");
         return;
     }
-    bool validData = true;
-    double storedSetpoints[NUM_CHANNELS];
-    for (int i = 0; i < NUM_CHANNELS; i++) {
-        EEPROM.get(EEPROM_SETPOINT_ADDR + i * sizeof(double), storedSetpoints[i]);
-        if (isnan(storedSetpoints[i]) || storedSetpoints[i] < MIN_SETPOINT || storedSetpoints[i] > MAX_SETPOINT) {
-            validData = false;
-            break;
+    // Одно чтение записи журнала; текущая раскладка проверяется прямо в буфере
+    static ConfigLoadBuffer buf;
+    bool loaded = false;
+    bool migrated = false;
+    if (journalReady && journal.hasRecord()) {
+        uint16_t tag = 0;
+        size_t length = journal.load(buf.raw, sizeof(buf.raw), &tag);
+        ConfigLoadReport report;
+        loaded = configDecode(buf, length, tag, report);
+        if (!loaded) {
+            Serial.println("[SETTINGS] Запись журнала несовместима, используются значения по умолчанию");
+        } else if (report.migrated) {
+            migrated = true;
+            Serial.printf("[SETTINGS] Конфигурация v%u приведена к v%u, полей по умолчанию: %u\n",
+                          report.fromVersion, CONFIG_VERSION, report.defaulted);
+        } else {
+            Serial.printf("[SETTINGS] Конфигурация загружена из журнала%s\n",
+                          report.defaulted ? " (часть значений сброшена)" : "");
         }
+    } else if (loadLegacyEEPROM(buf.blob)) {
+        loaded = migrated = true;
+        Serial.println("[SETTINGS] Настройки перенесены из EEPROM");
     }
-    if (validData) {
-        for (int i = 0; i < NUM_CHANNELS; i++) {
-            if (!channels[i])
-                continue;
-            channels[i]->setSetpoint(storedSetpoints[i]);
-            prevSetpoints[i] = storedSetpoints[i];
-        }
-        Serial.println("[EEPROM] Настройки загружены");
+    if (!loaded) {
+        configDefaults(buf.blob);
+        Serial.println("[SETTINGS] Установлены значения по умолчанию");
+    }
+
+    applyConfig(buf.blob);
+
+    // Значения по умолчанию не пишутся; перенесённая конфигурация сразу записывается в текущей версии
+    if (migrated && journalReady) {
+        appendConfig(buf.blob);
     } else {
-        for (int i = 0; i < NUM_CHANNELS; i++) {
-            if (!channels[i])
-                continue;
-            channels[i]->setSetpoint(DEFAULT_SETPOINT);
-            prevSetpoints[i] = DEFAULT_SETPOINT;
-            EEPROM.put(EEPROM_SETPOINT_ADDR + i * sizeof(double), DEFAULT_SETPOINT);
-        }
-        if (EEPROM.commit()) {
-            Serial.println("[EEPROM] Установлены значения по умолчанию");
-        } else {
-            Serial.println("[EEPROM] Ошибка записи значений по умолчанию!");
-        }
+        lastSaved = buf.blob;
+        lastSavedValid = true;
+    }
+    xSemaphoreGive(settingsMutex);
+}
+
+void maintainSettings() {
+    if (!journalReady || !settingsMutex) return;
+    if (!xSemaphoreTake(settingsMutex, 0)) return;  // Идёт сохранение - в следующий раз
+    if (journal.maintain()) {
+        Serial.println("[SETTINGS] Следующий сектор журнала стёрт заранее");
     }
-    xSemaphoreGive(eepromMutex);
+    xSemaphoreGive(settingsMutex);
 }
@@ -3,17 +3,20 @@
 #define EEPROM_HANDLER_H
 
 #include <Arduino.h>
-#include <EEPROM.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include "Config.h"
 #include "BaseChannel.h"
 
-// Инициализация EEPROM и мьютекса
-void initEEPROM();
-// Сохранение настроек (уставок) в EEPROM
-void saveSettings();
-// Загрузка настроек из EEPROM
+// Хранилище настроек: журнал во флеш (SettingsJournal) в разделе SETTINGS_PARTITION_LABEL.
+// Инициализация мьютекса и поиск последней записи журнала
+void initSettingsStore();
+// Сохранение настроек (уставок и калибровочных смещений); неизменившиеся не пишутся.
+// true - запись дописана в журнал. Пишет во флеш: вызывать только из задачи сохранения (Persistence).
+bool saveSettings();
+// Загрузка настроек в каналы; при пустом журнале - перенос из прежней EEPROM или значения по умолчанию
 void loadSettings();
+// Фоновое обслуживание журнала (заранее стирает следующий сектор). Только из задачи сохранения.
+void maintainSettings();
 
 #endif
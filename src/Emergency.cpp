@@ -1,35 +1,152 @@
 // Emergency.cpp
 // Реализация аварийного отключения системы.
+// Быстрый путь (heatersOffFast) только пишет регистры GPIO; всё медленное делает задача аварии.
 #include <Arduino.h>
+#include <atomic>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
+#include <esp_timer.h>
+#include <soc/gpio_sig_map.h>
 #include <cstring>
 #include "Emergency.h"
 #include "Globals.h"
 #include "Utils.h"
+#include "FastGPIO.h"
+#include "ChannelTable.h"
+#include "ControlTiming.h"
+#include "Persistence.h"
 
-void emergencyShutdown() {
-    if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(1000))) {
-        Serial.println("\n[EMERGENCY] Отключение!");
-        for (int i = 0; i < NUM_CHANNELS; i++) {
-            if (channels[i]) {
-                channels[i]->controlHeater(0);
-                channels[i]->emergencyStop();
-            }
+// Данные быстрого пути - в DRAM, чтобы он работал и при отключённом кэше флеш-памяти
+static DRAM_ATTR uint32_t heaterMaskLow = 0;    // Пины нагревателей 0..31
+static DRAM_ATTR uint32_t heaterMaskHigh = 0;   // Пины нагревателей 32..39
+static DRAM_ATTR uint32_t heaterOutSel[NUM_CHANNELS];
+static std::atomic<uint32_t> tripReason{SHUTDOWN_NONE};
+static DRAM_ATTR int64_t tripTimeUs = 0;
+static TaskHandle_t emergencyTask = NULL;
+
+static const char* reasonName(uint32_t reason) {
+    switch (reason) {
+        case SHUTDOWN_MANUAL:   return "команда";
+        case SHUTDOWN_WATCHDOG: return "пропуск срока задачи управления";
+        case SHUTDOWN_SELFTEST: return "самопроверка";
+        default:                return "нет";
+    }
+}
+
+void IRAM_ATTR heatersOffFast(ShutdownReason reason) {
+    // Сначала уровень 0 на выходах, затем отключение пинов от LEDC: пин сразу становится обычным GPIO с 0
+    REG_WRITE(GPIO_OUT_W1TC_REG, heaterMaskLow);
+    REG_WRITE(GPIO_OUT1_W1TC_REG, heaterMaskHigh);
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        REG_WRITE(heaterOutSel[i], SIG_GPIO_OUT_IDX | GPIO_FUNC0_OEN_SEL);
+    }
+
+    // Фиксируется первая причина; повторные вызовы только повторяют запись регистров
+    uint32_t expected = SHUTDOWN_NONE;
+    if (tripReason.compare_exchange_strong(expected, reason)) {
+        tripTimeUs = esp_timer_get_time();
+        if (!emergencyTask) return;
+        if (xPortInIsrContext()) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(emergencyTask, &woken);
+            if (woken) portYIELD_FROM_ISR();
+        } else {
+            xTaskNotifyGive(emergencyTask);
         }
-        systemActive = false;
-        systemMode = STANDBY_MODE;
-        strncpy(baseServiceMsg, "АВАРИЯ", sizeof(baseServiceMsg));
-        baseServiceMsg[sizeof(baseServiceMsg)-1] = '\0';
-        for (int i = 0; i < 10; i++) {
-            beep(2000, 100);
-            vTaskDelay(pdMS_TO_TICKS(100)); // vTaskDelay вместо delay
+    }
+}
+
+bool heatersTripped() {
+    return tripReason.load() != SHUTDOWN_NONE;
+}
+
+ShutdownReason shutdownReason() {
+    return static_cast<ShutdownReason>(tripReason.load());
+}
+
+// Сигнал LEDC, который выводит на пин канал pwmChannel из таблицы.
+static uint32_t ledcSignal(uint8_t pwmChannel) {
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+    if (pwmSpeedMode(pwmChannel) == LEDC_HIGH_SPEED_MODE) return LEDC_HS_SIG_OUT0_IDX + pwmGroupChannel(pwmChannel);
+#endif
+    return LEDC_LS_SIG_OUT0_IDX + pwmGroupChannel(pwmChannel);
+}
+
+void rearmHeaters() {
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        if (channels[i]) channels[i]->controlHeater(0);
+        REG_WRITE(gpioOutSelReg(CHANNEL_TABLE[i].heaterPin), ledcSignal(CHANNEL_TABLE[i].pwmChannel));
+    }
+    tripReason.store(SHUTDOWN_NONE);
+    Serial.println("[EMERGENCY] Нагреватели снова подключены к ШИМ");
+}
+
+// Задача аварии: всё, что нельзя делать в быстром пути (журнал, режим, сигнал, сообщение).
+static void TaskEmergency(void *pvParameters) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t reason = tripReason.load();
+        if (reason == SHUTDOWN_NONE) continue;
+        int64_t delayUs = esp_timer_get_time() - tripTimeUs;
+        Serial.printf("\n[EMERGENCY] Нагреватели отключены: %s (обработка через %lld мкс)\n", reasonName(reason), delayUs);
+        if (reason == SHUTDOWN_SELFTEST) continue;  // Самопроверка взводит выходы сама
+        if (reason == SHUTDOWN_WATCHDOG) controlWatchdog.report();
+
+        // Выходы уже в 0; мьютекс нужен только для согласованного перевода режима
+        if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(1000))) {
+            for (int i = 0; i < NUM_CHANNELS; i++) {
+                if (channels[i]) channels[i]->controlHeater(0);
+            }
+            systemActive = false;
+            systemMode = STANDBY_MODE;
+            xSemaphoreGive(systemMutex);
+            notifyPersistence(PERSIST_EVENT_MODE);
+        } else {
+            Serial.println("[EMERGENCY] Не удалось захватить мьютекс, выходы отключены без смены режима");
         }
-        updateServiceMessage("***standby mode***");
+        alarmBeep();
+        updateServiceMessage("***EMERGENCY STOP***");
         Serial.println("[EMERGENCY] Аварийный режим завершён");
-        xSemaphoreGive(systemMutex);
-    } else {
-        Serial.println("[EMERGENCY] Не удалось захватить мьютекс!");
     }
 }
+
+void beginEmergency() {
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        uint8_t pin = CHANNEL_TABLE[i].heaterPin;
+        if (gpioHighBank(pin)) heaterMaskHigh |= gpioMask(pin);
+        else heaterMaskLow |= gpioMask(pin);
+        heaterOutSel[i] = gpioOutSelReg(pin);
+        REG_WRITE(gpioEnableSetReg(pin), gpioMask(pin));  // Выход разрешён и после отключения от LEDC
+    }
+    xTaskCreatePinnedToCore(TaskEmergency, "Emergency", 3072, NULL, EMERGENCY_TASK_PRIORITY, &emergencyTask, UI_TASK_CORE);
+}
+
+void emergencyShutdown() {
+    heatersOffFast(SHUTDOWN_MANUAL);
+}
+
+#ifdef SHUTDOWN_SELFTEST
+bool shutdownSelfTest() {
+    if (heatersTripped()) rearmHeaters();
+
+    uint32_t start = ESP.getCycleCount();
+    heatersOffFast(SHUTDOWN_SELFTEST);
+    uint32_t cycles = ESP.getCycleCount() - start;
+
+    // Проверка по регистрам: уровень 0 и пин отключён от LEDC
+    bool off = !(REG_READ(GPIO_OUT_REG) & heaterMaskLow) && !(REG_READ(GPIO_OUT1_REG) & heaterMaskHigh);
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        if ((REG_READ(heaterOutSel[i]) & 0x1FF) != SIG_GPIO_OUT_IDX) off = false;
+    }
+    float latencyUs = (float)cycles / ESP.getCpuFreqMHz();
+    bool pass = off && latencyUs <= SHUTDOWN_MAX_LATENCY_US;
+    Serial.printf("[SELFTEST] Аварийное отключение %d каналов: %.2f мкс (предел %d мкс), выходы %s - %s\n",
+                  NUM_CHANNELS, latencyUs, SHUTDOWN_MAX_LATENCY_US, off ? "сняты" : "НЕ СНЯТЫ",
+                  pass ? "OK" : "ОШИБКА");
+
+    vTaskDelay(pdMS_TO_TICKS(10));  // Даём задаче аварии отработать
+    rearmHeaters();
+    return pass;
+}
+#endif
@@ -2,9 +2,39 @@
 #ifndef EMERGENCY_H
 #define EMERGENCY_H
 
+#include <Arduino.h>
+
+// Причина аварийного отключения нагревателей
+enum ShutdownReason : uint32_t {
+    SHUTDOWN_NONE = 0,
+    SHUTDOWN_MANUAL,     // emergencyShutdown()
+    SHUTDOWN_WATCHDOG,   // Задача управления пропустила срок
+    SHUTDOWN_SELFTEST    // Проверка задержки отключения при старте
+};
+
+// Настройка быстрого пути (маски пинов нагревателей по CHANNEL_TABLE) и задачи обработки аварии.
+// Вызывается из setup() после создания каналов.
+void beginEmergency();
+// Быстрый путь: все выходы нагревателей в 0 за несколько записей в регистры, без блокировок.
+// Можно вызывать из любого контекста, включая прерывание. Пины отключаются от LEDC в матрице GPIO,
+// поэтому controlHeater() не может снова включить нагрев до rearmHeaters().
+// Сигнал, сообщение и перевод в STANDBY выполняет задача аварии уже после возврата.
+void heatersOffFast(ShutdownReason reason);
+// Нагреватели отключены быстрым путём и ещё не взведены заново.
+bool heatersTripped();
+// Причина последнего отключения (SHUTDOWN_NONE, если нагреватели взведены).
+ShutdownReason shutdownReason();
+// Возврат пинов нагревателей к каналам LEDC (скважность предварительно сбрасывается в 0).
+void rearmHeaters();
 // Аварийное отключение системы
 void emergencyShutdown();
 // Обновление сервисного сообщения
 void updateServiceMessage(const char* message);
 
+#ifdef SHUTDOWN_SELFTEST
+// Замер задержки от вызова heatersOffFast() до снятия всех выходов и проверка предела
+// SHUTDOWN_MAX_LATENCY_US. Запускать без силового питания нагревателей. Результат - в Serial.
+bool shutdownSelfTest();
+#endif
+
 #endif
@@ -0,0 +1,38 @@
+// FastGPIO.h
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+
+// Прямой доступ к регистрам GPIO ESP32 в обход digitalWrite/digitalRead.
+// Пины 0..31 обслуживаются регистрами OUT/IN, пины 32..39 - регистрами OUT1/IN1.
+
+// Минимальная длительность полупериода тактового сигнала в тактах CPU,
+// если не задан MAX6675_DELAY (в мкс). 24 такта при 240 МГц = 100 нс (мин. для MAX6675).
+#ifndef MAX6675_GUARD_CYCLES
+#define MAX6675_GUARD_CYCLES 24
+#endif
+
+constexpr uint32_t gpioMask(uint8_t pin) { return 1UL << (pin & 31); }
+constexpr bool gpioHighBank(uint8_t pin) { return pin >= 32; }
+constexpr uint32_t gpioSetReg(uint8_t pin) { return gpioHighBank(pin) ? GPIO_OUT1_W1TS_REG : GPIO_OUT_W1TS_REG; }
+constexpr uint32_t gpioClearReg(uint8_t pin) { return gpioHighBank(pin) ? GPIO_OUT1_W1TC_REG : GPIO_OUT_W1TC_REG; }
+constexpr uint32_t gpioInReg(uint8_t pin) { return gpioHighBank(pin) ? GPIO_IN1_REG : GPIO_IN_REG; }
+constexpr uint32_t gpioOutReg(uint8_t pin) { return gpioHighBank(pin) ? GPIO_OUT1_REG : GPIO_OUT_REG; }
+constexpr uint32_t gpioEnableSetReg(uint8_t pin) { return gpioHighBank(pin) ? GPIO_ENABLE1_W1TS_REG : GPIO_ENABLE_W1TS_REG; }
+// Регистр выбора выходного сигнала пина в матрице GPIO (LEDC, SPI или сам GPIO).
+constexpr uint32_t gpioOutSelReg(uint8_t pin) { return GPIO_FUNC0_OUT_SEL_CFG_REG + 4 * pin; }
+
+// Выдержка полупериода тактов шины: MAX6675_DELAY (мкс) или MAX6675_GUARD_CYCLES (такты CPU).
+static inline void IRAM_ATTR gpioTimingGuard() {
+#if defined(MAX6675_DELAY)
+    delayMicroseconds(MAX6675_DELAY);
+#elif MAX6675_GUARD_CYCLES > 0
+    uint32_t start = ESP.getCycleCount();
+    while (ESP.getCycleCount() - start < MAX6675_GUARD_CYCLES) {}
+#endif
+}
+
+#endif
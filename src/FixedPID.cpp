@@ -0,0 +1,84 @@
+// FixedPID.cpp
+// PID-регулятор с фиксированной точкой Q16.16 для горячего пути задачи управления.
+#include <Arduino.h>
+#include "FixedPID.h"
+
+FixedPID::FixedPID(float kp, float ki, float kd, uint32_t dtMs)
+    : kp(kp), ki(ki), kd(kd), dtMs(dtMs > 0 ? dtMs : 1),
+      minOut(0), maxOut(255L << 16), integral(0), prevInput(0), output(0),
+      direction(false), mode(false)
+{
+    updateGains();
+}
+
+void FixedPID::setTunings(float kp, float ki, float kd) {
+    this->kp = kp;
+    this->ki = ki;
+    this->kd = kd;
+    updateGains();
+}
+
+void FixedPID::setDt(uint32_t dtMs) {
+    if (dtMs == 0 || dtMs == this->dtMs) return;
+    this->dtMs = dtMs;
+    updateGains();
+}
+
+void FixedPID::setLimits(int16_t minOutput, int16_t maxOutput) {
+    minOut = static_cast<q16_t>(minOutput) << 16;
+    maxOut = static_cast<q16_t>(maxOutput) << 16;
+}
+
+void FixedPID::reset() {
+    integral = 0;
+    prevInput = 0;
+}
+
+void FixedPID::updateGains() {
+    float dtS = dtMs / 1000.0f;
+    kpQ = floatToQ16(kp);
+    kiDtQ = floatToQ16(ki * dtS);
+    kdDtQ = floatToQ16(kd / dtS);
+}
+
+q16_t FixedPID::compute(q16_t setpoint, q16_t input) {
+    output = q16PidStep(setpoint, input, prevInput, integral, kpQ, kiDtQ, kdDtQ, minOut, maxOut, direction, mode);
+    return output;
+}
+
+#ifdef PID_BENCHMARK
+#include <GyverPID.h>
+
+void benchmarkPID() {
+    const int steps = 5000;
+    const uint32_t dtMs = 2 * CONTROL_PERIOD_MS;
+    GyverPID ref(PID_KP, PID_KI, PID_KD, dtMs);
+    FixedPID fixed(PID_KP, PID_KI, PID_KD, dtMs);
+    ref.setLimits(0, PWM_MAX_DUTY);
+    fixed.setLimits(0, PWM_MAX_DUTY);
+
+    // Объект первого порядка, общий для обоих регуляторов (управляется эталоном)
+    float temp = 25.0f;
+    float maxDiff = 0.0f;
+    uint32_t refCycles = 0, fixedCycles = 0;
+    for (int i = 0; i < steps; i++) {
+        float sp = (i < steps / 2) ? 200.0f : 150.0f;
+        ref.setpoint = sp;
+        ref.input = temp;
+
+        uint32_t start = ESP.getCycleCount();
+        float refOut = ref.getResult();
+        refCycles += ESP.getCycleCount() - start;
+
+        start = ESP.getCycleCount();
+        float fixedOut = fixed.getResult(sp, temp);
+        fixedCycles += ESP.getCycleCount() - start;
+
+        float diff = fabsf(refOut - fixedOut);
+        if (diff > maxDiff) maxDiff = diff;
+        temp += (25.0f + 450.0f * refOut / PWM_MAX_DUTY - temp) * (dtMs / 60000.0f);
+    }
+    Serial.printf("[BENCH] PID: GyverPID %.1f тактов, FixedPID %.1f тактов, макс. расхождение выхода %.3f\n",
+                  (float)refCycles / steps, (float)fixedCycles / steps, maxDiff);
+}
+#endif
@@ -0,0 +1,109 @@
+// FixedPID.h
+#ifndef FIXED_PID_H
+#define FIXED_PID_H
+
+#include <Arduino.h>
+
+// Число с фиксированной точкой Q16.16
+typedef int32_t q16_t;
+
+#define Q16_ONE (1L << 16)
+
+inline q16_t floatToQ16(float v) {
+    float scaled = v * Q16_ONE;
+    if (scaled >= 2147483647.0f) return INT32_MAX;
+    if (scaled <= -2147483648.0f) return INT32_MIN;
+    return static_cast<q16_t>(lroundf(scaled));
+}
+inline float q16ToFloat(q16_t v) { return v / (float)Q16_ONE; }
+
+// Насыщающая арифметика Q16.16
+inline q16_t q16Saturate(int64_t v) {
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return static_cast<q16_t>(v);
+}
+inline q16_t q16Add(q16_t a, q16_t b) { return q16Saturate(static_cast<int64_t>(a) + b); }
+inline q16_t q16Sub(q16_t a, q16_t b) { return q16Saturate(static_cast<int64_t>(a) - b); }
+// Произведение с округлением до ближайшего
+inline q16_t q16Mul(q16_t a, q16_t b) { return q16Saturate((static_cast<int64_t>(a) * b + (Q16_ONE / 2)) >> 16); }
+inline q16_t q16Clamp(q16_t v, q16_t lo, q16_t hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+// Один шаг PID в Q16.16 - общее ядро FixedPID::compute() и PIDBank::update().
+// prevInput и integral обновляются на месте; возвращается выход в пределах [minOut, maxOut].
+// kdDtQ = Kd/dt, kiDtQ = Ki*dt; reverse - направление REVERSE, rate - режим ON_RATE.
+inline q16_t q16PidStep(q16_t setpoint, q16_t input, q16_t& prevInput, q16_t& integral,
+                        q16_t kpQ, q16_t kiDtQ, q16_t kdDtQ, q16_t minOut, q16_t maxOut,
+                        bool reverse, bool rate) {
+    q16_t error = q16Sub(setpoint, input);        // Ошибка регулирования
+    q16_t deltaInput = q16Sub(prevInput, input);  // Изменение входа за dt
+    prevInput = input;
+    if (reverse) {
+        error = q16Sub(0, error);
+        deltaInput = q16Sub(0, deltaInput);
+    }
+
+    q16_t out = rate ? 0 : q16Mul(error, kpQ);     // Пропорциональная составляющая
+    out = q16Add(out, q16Mul(deltaInput, kdDtQ));  // Дифференциальная составляющая
+
+    q16_t integ = q16Add(integral, q16Mul(error, kiDtQ));
+    if (rate) integ = q16Add(integ, q16Mul(deltaInput, kpQ));  // Режим по скорости
+    integral = q16Clamp(integ, minOut, maxOut);
+
+    return q16Clamp(q16Add(out, integral), minOut, maxOut);
+}
+
+// PID-регулятор на целых числах Q16.16 с насыщающей арифметикой.
+// Повторяет поведение GyverPID::getResult(): P по ошибке (или ON_RATE - по изменению входа),
+// D по изменению входа, ограничение интегральной суммы и выхода пределами setLimits(),
+// инверсия направления REVERSE. Произведения Ki*dt и Kd/dt пересчитываются только
+// при смене коэффициентов или шага, так что в расчёте нет ни float, ни деления.
+class FixedPID {
+public:
+    FixedPID(float kp, float ki, float kd, uint32_t dtMs = 100);
+
+    // Коэффициенты в тех же единицах, что и у GyverPID.
+    void setTunings(float kp, float ki, float kd);
+    // Шаг дискретизации, мс. Коэффициенты пересчитываются только при изменении шага.
+    void setDt(uint32_t dtMs);
+    void setLimits(int16_t minOutput, int16_t maxOutput);
+    // NORMAL (0) или REVERSE (1)
+    void setDirection(bool direction) { this->direction = direction; }
+    // ON_ERROR (0) или ON_RATE (1)
+    void setMode(bool mode) { this->mode = mode; }
+    void reset();
+
+    // Расчёт выхода по уставке и входу в Q16.16.
+    q16_t compute(q16_t setpoint, q16_t input);
+    // То же для значений в float (преобразование только на входе).
+    float getResult(float setpoint, float input) { return q16ToFloat(compute(floatToQ16(setpoint), floatToQ16(input))); }
+
+    // Последний выход, округлённый до целого (значение для ШИМ).
+    int getOutput() const { return (output + (Q16_ONE / 2)) >> 16; }
+    q16_t getOutputQ16() const { return output; }
+    float getIntegral() const { return q16ToFloat(integral); }
+    float getKp() const { return kp; }
+    float getKi() const { return ki; }
+    float getKd() const { return kd; }
+
+private:
+    float kp, ki, kd;         // Коэффициенты в исходном виде (для пересчёта и отображения)
+    uint32_t dtMs;
+    q16_t kpQ, kiDtQ, kdDtQ;  // Kp, Ki*dt, Kd/dt
+    q16_t minOut, maxOut;
+    q16_t integral;
+    q16_t prevInput;
+    q16_t output;
+    bool direction;
+    bool mode;
+
+    void updateGains();
+};
+
+#ifdef PID_BENCHMARK
+// Сравнение FixedPID с GyverPID на модели объекта: максимальное расхождение выхода
+// и такты CPU на расчёт, вывод в Serial.
+void benchmarkPID();
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+// FlashRegion.cpp
+// Доступ к секторам флеш: раздел ESP32 или файловая имитация на хосте.
+#include "FlashRegion.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Arduino.h>
+#include "ControlTiming.h"
+
+PartitionFlash::PartitionFlash(const char* label) : label(label), partition(NULL) {}
+
+bool PartitionFlash::begin() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!partition) {
+        Serial.printf("[FLASH] Раздел \"%s\" не найден в таблице разделов\n", label);
+        return false;
+    }
+    return true;
+}
+
+bool PartitionFlash::read(uint32_t offset, void* dst, size_t len) {
+    return partition && esp_partition_read(partition, offset, dst, len) == ESP_OK;
+}
+
+// Запись и стирание останавливают оба ядра (кэш флеш отключён) - надзор за задачей управления
+// на это время приостанавливается (см. CONTROL_WATCHDOG_FLASH_MAX_MS)
+bool PartitionFlash::write(uint32_t offset, const void* src, size_t len) {
+    if (!partition) return false;
+    controlWatchdog.flashBegin();
+    bool ok = esp_partition_write(partition, offset, src, len) == ESP_OK;
+    controlWatchdog.flashEnd();
+    return ok;
+}
+
+bool PartitionFlash::eraseSector(size_t sector) {
+    if (!partition) return false;
+    controlWatchdog.flashBegin();
+    bool ok = esp_partition_erase_range(partition, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+    controlWatchdog.flashEnd();
+    return ok;
+}
+
+#else
+
+#include <stdlib.h>
+#include <string.h>
+
+FileFlash::FileFlash(const char* path, size_t sectorSize, size_t sectorCount)
+    : path(path), sectorBytes(sectorSize), sectors(sectorCount), file(NULL),
+      erases(static_cast<uint32_t*>(calloc(sectorCount, sizeof(uint32_t)))) {}
+
+FileFlash::~FileFlash() {
+    if (file) fclose(file);
+    free(erases);
+}
+
+bool FileFlash::begin() {
+    file = fopen(path, "r+b");
+    if (!file) file = fopen(path, "w+b");
+    if (!file || !erases) return false;
+
+    // Недостающий хвост файла - стёртая флеш
+    fseek(file, 0, SEEK_END);
+    long have = ftell(file);
+    for (long pos = have; pos < static_cast<long>(size()); pos++) fputc(0xFF, file);
+    return fflush(file) == 0;
+}
+
+bool FileFlash::read(uint32_t offset, void* dst, size_t len) {
+    if (!file || offset + len > size()) return false;
+    fseek(file, offset, SEEK_SET);
+    return fread(dst, 1, len, file) == len;
+}
+
+bool FileFlash::write(uint32_t offset, const void* src, size_t len) {
+    if (!file || offset + len > size()) return false;
+    // Запись во флеш только сбрасывает биты: новое значение - И со старым
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    uint8_t chunk[64];
+    while (len) {
+        size_t n = len < sizeof(chunk) ? len : sizeof(chunk);
+        if (!read(offset, chunk, n)) return false;
+        for (size_t k = 0; k < n; k++) chunk[k] &= in[k];
+        fseek(file, offset, SEEK_SET);
+        if (fwrite(chunk, 1, n, file) != n) return false;
+        offset += n;
+        in += n;
+        len -= n;
+    }
+    return fflush(file) == 0;
+}
+
+bool FileFlash::eraseSector(size_t sector) {
+    if (!file || sector >= sectors) return false;
+    uint8_t blank[64];
+    memset(blank, 0xFF, sizeof(blank));
+    fseek(file, sector * sectorBytes, SEEK_SET);
+    for (size_t done = 0; done < sectorBytes; done += sizeof(blank)) {
+        size_t n = sectorBytes - done < sizeof(blank) ? sectorBytes - done : sizeof(blank);
+        if (fwrite(blank, 1, n, file) != n) return false;
+    }
+    erases[sector]++;
+    return fflush(file) == 0;
+}
+
+#endif
@@ -0,0 +1,76 @@
+// FlashRegion.h
+#ifndef FLASH_REGION_H
+#define FLASH_REGION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Область NOR-флеш, разбитая на секторы: стирание только сектором целиком (в 0xFF),
+// запись может только сбрасывать биты. Адреса - смещения от начала области.
+// Реализации: PartitionFlash (раздел флеш ESP32) и FileFlash (файл на хосте для отладки и тестов).
+class FlashRegion {
+public:
+    virtual ~FlashRegion() = default;
+
+    virtual size_t sectorSize() const = 0;
+    virtual size_t sectorCount() const = 0;
+    virtual bool read(uint32_t offset, void* dst, size_t len) = 0;
+    virtual bool write(uint32_t offset, const void* src, size_t len) = 0;
+    virtual bool eraseSector(size_t sector) = 0;
+
+    size_t size() const { return sectorSize() * sectorCount(); }
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_partition.h>
+
+// Раздел данных ESP32 по метке из таблицы разделов (partitions.csv).
+class PartitionFlash : public FlashRegion {
+public:
+    explicit PartitionFlash(const char* label);
+
+    // Поиск раздела. false - раздела с такой меткой нет.
+    bool begin();
+
+    size_t sectorSize() const override { return SPI_FLASH_SEC_SIZE; }
+    size_t sectorCount() const override { return partition ? partition->size / SPI_FLASH_SEC_SIZE : 0; }
+    bool read(uint32_t offset, void* dst, size_t len) override;
+    bool write(uint32_t offset, const void* src, size_t len) override;
+    bool eraseSector(size_t sector) override;
+
+private:
+    const char* label;
+    const esp_partition_t* partition;
+};
+
+#else
+#include <stdio.h>
+
+// Файл, ведущий себя как NOR-флеш: стирание заполняет сектор 0xFF, запись - побитовое И
+// со старым содержимым. Считает стирания по секторам для оценки износа.
+class FileFlash : public FlashRegion {
+public:
+    FileFlash(const char* path, size_t sectorSize, size_t sectorCount);
+    ~FileFlash() override;
+
+    // Открытие файла; отсутствующий или короткий файл дополняется стёртыми секторами.
+    bool begin();
+
+    size_t sectorSize() const override { return sectorBytes; }
+    size_t sectorCount() const override { return sectors; }
+    bool read(uint32_t offset, void* dst, size_t len) override;
+    bool write(uint32_t offset, const void* src, size_t len) override;
+    bool eraseSector(size_t sector) override;
+
+    uint32_t eraseCount(size_t sector) const { return sector < sectors ? erases[sector] : 0; }
+
+private:
+    const char* path;
+    size_t sectorBytes;
+    size_t sectors;
+    FILE* file;
+    uint32_t* erases;
+};
+#endif
+
+#endif
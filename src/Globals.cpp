@@ -6,6 +6,7 @@ SystemMode systemMode = STANDBY_MODE;   // Текущий режим систе
 SemaphoreHandle_t systemMutex = NULL;   // Мьютекс для глобальных ресурсов
 SemaphoreHandle_t displayMutex = NULL;  // Мьютекс для дисплея
 BaseChannel* channels[NUM_CHANNELS] = {nullptr};  // Массив указателей на каналы
+ChannelSampleRing sampleRings[NUM_CHANNELS];       // Отсчёты датчиков по каналам (пишет задача управления)
 bool systemActive = true;               // Флаг активности системы
 bool settingModeActive = false;         // Флаг режима настройки
 char baseServiceMsg[32] = "***standby mode***";  // Сервисное сообщение
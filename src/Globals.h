@@ -8,6 +8,7 @@
 
 #include "Config.h"
 #include "BaseChannel.h"
+#include "SampleRing.h"
 
 // Перечисление режимов работы системы
 enum SystemMode {
@@ -23,6 +24,7 @@ extern SystemMode systemMode;
 extern SemaphoreHandle_t systemMutex;
 extern SemaphoreHandle_t displayMutex;
 extern BaseChannel* channels[NUM_CHANNELS];
+extern ChannelSampleRing sampleRings[NUM_CHANNELS];
 extern bool systemActive;
 extern bool settingModeActive;
 extern char baseServiceMsg[32];
@@ -7,39 +7,34 @@
 #include "HeaterChannel.h"
 #include "Utils.h"
 
-#define EEPROM_CALIB_OFFSET_ADDR 0
-#define MAX_CALIB_OFFSET 50.0
-
-// Конструктор: инициализирует датчики, энкодер и настраивает PWM через старый LEDC API.
-HeaterChannel::HeaterChannel(GyverMAX6675<18, 17, 4>* sensor1,
-                             GyverMAX6675<18, 5, 16>* sensor2,
-                             GyverMAX6675<18, 19, 23>* sensor3,
+// Конструктор: инициализирует датчики, энкодер и настраивает PWM по строке таблицы каналов.
+HeaterChannel::HeaterChannel(const ChannelDescriptor& desc,
+                             ChannelSampleRing* samples,
                              EncButton* encoder,
-                             uint8_t heaterPin,
-                             uint8_t pwmChannel,
-                             ledc_timer_t pwmTimer,
-                             int channelIndex,
-                             double defaultSP)
-    : sensor1(sensor1), sensor2(sensor2), sensor3(sensor3), encoder(encoder),
-      pid(PID_KP, PID_KI, PID_KD),
-      heaterPin(heaterPin), pwmChannel(pwmChannel), pwmTimer(pwmTimer),
-      channelIndex(channelIndex), setpoint(defaultSP), calibrationOffset(0.0), temperature(0.0)
+                             int channelIndex)
+    : samples(samples), sampleCursor(samples->tail()), encoder(encoder),
+      pid(&pidBank, channelIndex),
+      heaterPin(desc.heaterPin), pwmMode(pwmSpeedMode(desc.pwmChannel)),
+      pwmChannel(pwmGroupChannel(desc.pwmChannel)), pwmTimer(static_cast<ledc_timer_t>(desc.pwmTimer)),
+      channelIndex(channelIndex), minSetpoint(desc.minSetpoint), maxSetpoint(desc.maxSetpoint),
+      setpoint(desc.defaultSetpoint), temperature(0.0f), calibrationOffset(0.0f), duty(0)
 {
     configurePWM();
+    pid.setTunings(PID_KP, PID_KI, PID_KD);
     pid.setLimits(0, PWM_MAX_DUTY);
+    pid.setSetpoint(setpoint);
 
-    EEPROM.get(EEPROM_CALIB_OFFSET_ADDR + channelIndex * sizeof(double), calibrationOffset);
-    if (isnan(calibrationOffset) || fabs(calibrationOffset) > MAX_CALIB_OFFSET) {
-        calibrationOffset = 0.0;
-        EEPROM.put(EEPROM_CALIB_OFFSET_ADDR + channelIndex * sizeof(double), calibrationOffset);
-        Serial.printf("[EEPROM] CH%d: Некорректное смещение, сброшено на 0\n", channelIndex + 1);
-    }
+    // Фильтр по умолчанию; частота отсчётов - один раз в два цикла задачи управления
+    const float sampleRateHz = 1000.0f / (2 * CONTROL_PERIOD_MS);
+    filter.configure(0, FILTER_MEDIAN, FILTER_MEDIAN_SIZE, sampleRateHz);
+    filter.configure(1, FILTER_SMOOTH_TYPE, FILTER_SMOOTH_PARAM, sampleRateHz);
 }
 
-// Настройка PWM с использованием старого API: ledc_timer_config и ledc_channel_config.
+// Настройка PWM через ledc_timer_config и ledc_channel_config в группе канала.
+// Таймер с теми же параметрами может настраиваться повторно, если его делят несколько каналов.
 void HeaterChannel::configurePWM() {
     ledc_timer_config_t timerConf = {
-        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .speed_mode = pwmMode,
         .duty_resolution = static_cast<ledc_timer_bit_t>(PWM_RESOLUTION),
         .timer_num = pwmTimer,
         .freq_hz = PWM_FREQUENCY,
@@ -49,8 +44,8 @@ void HeaterChannel::configurePWM() {
 
     ledc_channel_config_t channelConf = {
         .gpio_num = heaterPin,
-        .speed_mode = LEDC_LOW_SPEED_MODE,
-        .channel = static_cast<ledc_channel_t>(pwmChannel),
+        .speed_mode = pwmMode,
+        .channel = pwmChannel,
         .timer_sel = pwmTimer,
         .duty = 0,
         .hpoint = 0
@@ -66,13 +61,22 @@ void HeaterChannel::emergencyStop() {
     errorBeep();
 }
 
-// Чтение и обновление температуры.
+// Чтение и обновление температуры из кольца отсчётов канала.
+// Вызывается задачей управления при появлении нового отсчёта датчика; берётся самый свежий.
+// Отфильтрованное значение передаётся во вход PID вместе с меткой времени отсчёта.
 void HeaterChannel::readAndUpdateTemperature() {
-    switch (channelIndex) {
-        case 0: temperature = sensor1->readTemp(); break;
-        case 1: temperature = sensor2->readTemp(); break;
-        case 2: temperature = sensor3->readTemp(); break;
-        default: temperature = NAN; break;
+    RawSample sample, newest;
+    bool received = false;
+    while (samples->pop(sampleCursor, sample)) {
+        newest = sample;
+        received = true;
+    }
+    if (!received) return;
+    if (sampleValid(newest)) {
+        temperature = filter.apply(sampleToCelsius(newest));
+        pid.setInput(getTemperature(), newest.tick);
+    } else {
+        temperature = NAN;
     }
     if (temperature < -100 || isnan(temperature)) {
         Serial.printf("[ERROR] CH%d: Неисправность датчика\n", channelIndex + 1);
@@ -80,33 +84,20 @@ void HeaterChannel::readAndUpdateTemperature() {
     }
 }
 
-// Обновление PID-регулятора.
-void HeaterChannel::updatePID() {
-    pid.setpoint = setpoint;
-    pid.input = getTemperature();
-    pid.getResult();
-    static bool wasReached[NUM_CHANNELS] = {false};
-    if (fabs(getTemperature() - setpoint) < 0.5 && !wasReached[channelIndex]) {
-        confirmBeep();
-        wasReached[channelIndex] = true;
-    }
-    else if (fabs(getTemperature() - setpoint) >= 0.5) {
-        wasReached[channelIndex] = false;
-    }
-}
-
-// Управление нагревателем с использованием старых функций: ledcWrite.
+// Управление нагревателем: скважность пишется в тот же канал и группу LEDC, что настроены в configurePWM()
+// (ledcWrite() Arduino нумерует каналы по-своему и попадал не в ту группу).
 void HeaterChannel::controlHeater(int value) {
-    ledcWrite(static_cast<ledc_channel_t>(pwmChannel), value);
+    duty = constrain(value, 0, PWM_MAX_DUTY);
+    ledc_set_duty(pwmMode, pwmChannel, duty);
+    ledc_update_duty(pwmMode, pwmChannel);
 }
 
 // Обработка событий энкодера для изменения уставки.
 void HeaterChannel::processEncoder(unsigned long currentMillis, bool &changedFlag) {
     encoder->tick();
     if (encoder->turn()) {
-        double delta = encoder->dir() * 0.5;
-        setpoint += delta;
-        setpoint = constrain(setpoint, MIN_SETPOINT, MAX_SETPOINT);
+        float delta = encoder->dir() * 0.5f;
+        setSetpoint(setpoint + delta);
         changedFlag = true;
     }
 }
@@ -2,59 +2,75 @@
 #ifndef HEATER_CHANNEL_H
 #define HEATER_CHANNEL_H
 
-#include <GyverMAX6675.h>
 #include <EncButton.h>
-#include <GyverPID.h>
-#include <EEPROM.h>
 #include "BaseChannel.h"
+#include "PIDBank.h"
 #include "Config.h"
+#include "SampleRing.h"
+#include "ChannelTable.h"
 #include <driver/ledc.h>
+#include <freertos/FreeRTOS.h>
 
 // Класс HeaterChannel, реализующий управление нагревателем посредством термопары, энкодера, PWM и PID.
+// PID канала - ячейка общего PIDBank (фиксированная точка, пакетный расчёт всех каналов).
 class HeaterChannel : public BaseChannel {
 public:
-    // Конструктор: принимает указатели на датчики, энкодер, пин нагревателя, PWM-параметры, индекс канала и начальную уставку.
-    HeaterChannel(GyverMAX6675<18, 17, 4>* sensor1,  // Канал 1
-                  GyverMAX6675<18, 5, 16>* sensor2,  // Канал 2
-                  GyverMAX6675<18, 19, 23>* sensor3, // Канал 3
-                  EncButton* encoder, 
-                  uint8_t heaterPin, 
-                  uint8_t pwmChannel,     // /// MODIFIED: Этот параметр теперь не используется, но остается для совместимости
-                  ledc_timer_t pwmTimer,    // также не используется в новой LEDC API
-                  int channelIndex, 
-                  double defaultSP);
+    // Конструктор: принимает строку таблицы каналов (нагреватель, LEDC, пределы уставки),
+    // кольцо отсчётов канала, энкодер и индекс канала.
+    // Отсчёты в кольцо кладёт задача управления; канал читает их своим курсором.
+    HeaterChannel(const ChannelDescriptor& desc,
+                  ChannelSampleRing* samples,
+                  EncButton* encoder,
+                  int channelIndex);
     ~HeaterChannel() override = default;
     
     void emergencyStop() override;
     void readAndUpdateTemperature() override;
-    void updatePID() override;
     void controlHeater(int value) override;
     void processEncoder(unsigned long currentMillis, bool &changedFlag) override;
     void updateDisplay() override {}  // Не используется в данном классе
 
-    GyverPID& getPID() override { return pid; }
-    double getSetpoint() const override { return setpoint; }
-    void setSetpoint(double sp) override { setpoint = constrain(sp, MIN_SETPOINT, MAX_SETPOINT); }
+    PIDBank::Channel& getPID() override { return pid; }
+    TemperatureFilter& getFilter() override { return filter; }
+    float getSetpoint() const override { return setpoint; }
+    void setSetpoint(float sp) override {
+        setpoint = constrain(sp, minSetpoint, maxSetpoint);
+        pid.setSetpoint(setpoint);
+    }
+    float getMinSetpoint() const override { return minSetpoint; }
+    float getMaxSetpoint() const override { return maxSetpoint; }
+    void setSetpointLimits(float minSp, float maxSp) override {
+        minSetpoint = minSp;
+        maxSetpoint = maxSp;
+        setSetpoint(setpoint);
+    }
     // Возвращает фактическую температуру с учетом калибровочного смещения.
-    double getTemperature() const override { return temperature + calibrationOffset; }
-    int getOutput() override { return static_cast<int>(pid.getResult()); }
+    float getTemperature() const override { return temperature + calibrationOffset; }
+    float getCalibrationOffset() const override { return calibrationOffset; }
+    void setCalibrationOffset(float offset) override { calibrationOffset = offset; }
+    // Последний рассчитанный выход PID (расчёт - PIDBank::update() в задаче управления).
+    int getOutput() override { return pid.getOutput(); }
+    int getDuty() const override { return duty; }
 
 private:
-    // Датчики температуры
-    GyverMAX6675<18, 17, 4>* sensor1;
-    GyverMAX6675<18, 5, 16>* sensor2;
-    GyverMAX6675<18, 19, 23>* sensor3;
+    ChannelSampleRing* samples; // Кольцо отсчётов датчика канала
+    SampleCursor sampleCursor;  // Позиция PID-потребителя в кольце
     EncButton* encoder; // Указатель на энкодер
-    GyverPID pid;       // PID-регулятор
+    PIDBank::Channel pid; // PID-регулятор (ячейка pidBank)
+    TemperatureFilter filter; // Фильтр показаний датчика перед PID
 
     // Аппаратные параметры
     uint8_t heaterPin;  // Пин, к которому подключен нагреватель
-    uint8_t pwmChannel; // Не используется в новой реализации
-    ledc_timer_t pwmTimer; // Не используется в новой реализации
-    int channelIndex;   // Индекс канала (0,1,2)
-    double setpoint;    // Заданная уставка температуры
-    double temperature; // Измеренная температура
-    double calibrationOffset; // Калибровочное смещение (считывается из EEPROM)
+    ledc_mode_t pwmMode;       // Группа LEDC канала
+    ledc_channel_t pwmChannel; // Канал LEDC внутри группы
+    ledc_timer_t pwmTimer;     // Таймер LEDC внутри группы
+    int channelIndex;   // Индекс канала (строка CHANNEL_TABLE)
+    float minSetpoint;  // Пределы уставки канала
+    float maxSetpoint;
+    float setpoint;     // Заданная уставка температуры
+    float temperature;  // Измеренная температура (после фильтра)
+    float calibrationOffset; // Калибровочное смещение (задаётся из сохранённых настроек)
+    int duty;           // Последняя поданная скважность
 
     // Метод для настройки LEDC нового API.
     void configurePWM();
@@ -0,0 +1,154 @@
+// History.cpp
+// История температур в RAM: кольца точек по уровням с прореживанием через накопители min/max/суммы.
+#include <Arduino.h>
+#include <math.h>
+#include "History.h"
+#include "Config.h"
+
+static_assert(HISTORY_TIER1_PERIOD_MS % CONTROL_PERIOD_MS == 0, "Период уровня 1 - целое число циклов управления");
+static_assert(HISTORY_TIER2_PERIOD_MS % HISTORY_TIER1_PERIOD_MS == 0, "Период уровня 2 - целое число точек уровня 1");
+static_assert(HISTORY_TIER2_PERIOD_MS / CONTROL_PERIOD_MS <= UINT16_MAX, "Отсчётов в точке уровня 2 - не больше счётчика накопителя");
+
+static const uint32_t TIER1_SAMPLES = HISTORY_TIER1_PERIOD_MS / CONTROL_PERIOD_MS;
+static const uint32_t TIER2_POINTS = HISTORY_TIER2_PERIOD_MS / HISTORY_TIER1_PERIOD_MS;
+
+// Читается на одну точку меньше размера кольца (см. HistoryRing::get), отсюда + 1
+static const uint32_t TIER0_SIZE = HISTORY_TIER0_SPAN_MS / CONTROL_PERIOD_MS + 1;
+static const uint32_t TIER1_SIZE = HISTORY_TIER1_SPAN_MS / HISTORY_TIER1_PERIOD_MS + 1;
+static const uint32_t TIER2_SIZE = HISTORY_TIER2_SPAN_MS / HISTORY_TIER2_PERIOD_MS + 1;
+
+// История одного канала. Накопители и счётчики трогает только задача управления.
+// Формат точек по уровням: 2 байта (один отсчёт), 4 байта (секунда), 6 байт (минута) -
+// при глубинах по умолчанию ~24 КБ на канал (при 3 каналах; глубины сокращаются с ростом NUM_CHANNELS).
+struct ChannelHistory {
+    HistoryRing<TIER0_SIZE, HistorySlotValue> tier0;
+    HistoryRing<TIER1_SIZE, HistorySlotDelta> tier1;
+    HistoryRing<TIER2_SIZE, HistorySlotFull> tier2;
+    HistoryAccumulator acc1;
+    HistoryAccumulator acc2;
+    uint32_t samples1;      // Отсчётов в текущей точке уровня 1
+    uint32_t points2;       // Точек уровня 1 в текущей точке уровня 2
+
+    ChannelHistory() : samples1(0), points2(0) {
+        acc1.reset();
+        acc2.reset();
+    }
+};
+
+static_assert(sizeof(ChannelHistory) * NUM_CHANNELS <= HISTORY_RAM_BUDGET,
+              "История температур не помещается в HISTORY_RAM_BUDGET: уменьшите HISTORY_*_SPAN_MS или NUM_CHANNELS");
+
+static ChannelHistory histories[NUM_CHANNELS];
+static uint32_t reportedMinutes = 0;
+
+// Температура в 0.1 °C с насыщением в int16
+static int16_t toHistoryUnits(float value) {
+    if (isnan(value)) return HISTORY_INVALID;
+    long v = lroundf(value * HISTORY_SCALE);
+    if (v <= INT16_MIN) return INT16_MIN + 1;
+    if (v > INT16_MAX) return INT16_MAX;
+    return static_cast<int16_t>(v);
+}
+
+void historyAdd(const SystemSnapshot& snap) {
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        ChannelHistory& h = histories[i];
+        int16_t v = toHistoryUnits(snap.channels[i].temperature);
+        HistoryPoint raw = {v, v, v};
+        h.tier0.push(raw);
+
+        h.acc1.add(v);
+        if (++h.samples1 < TIER1_SAMPLES) continue;
+        // Точка уровня 1 готова; её накопитель целиком переходит в накопитель уровня 2
+        h.tier1.push(h.acc1.point());
+        h.acc2.merge(h.acc1);
+        h.acc1.reset();
+        h.samples1 = 0;
+
+        if (++h.points2 < TIER2_POINTS) continue;
+        h.tier2.push(h.acc2.point());
+        h.acc2.reset();
+        h.points2 = 0;
+    }
+}
+
+bool historyPoint(uint8_t channel, uint8_t tier, uint32_t age, HistoryPoint& out) {
+    if (channel >= NUM_CHANNELS) return false;
+    const ChannelHistory& h = histories[channel];
+    switch (tier) {
+        case HISTORY_TIER_CYCLE:  return h.tier0.get(age, out);
+        case HISTORY_TIER_SECOND: return h.tier1.get(age, out);
+        case HISTORY_TIER_MINUTE: return h.tier2.get(age, out);
+        default: return false;
+    }
+}
+
+uint32_t historyCount(uint8_t channel, uint8_t tier) {
+    if (channel >= NUM_CHANNELS) return 0;
+    const ChannelHistory& h = histories[channel];
+    switch (tier) {
+        case HISTORY_TIER_CYCLE:  return h.tier0.count();
+        case HISTORY_TIER_SECOND: return h.tier1.count();
+        case HISTORY_TIER_MINUTE: return h.tier2.count();
+        default: return 0;
+    }
+}
+
+uint32_t historyPeriodMs(uint8_t tier) {
+    switch (tier) {
+        case HISTORY_TIER_CYCLE:  return CONTROL_PERIOD_MS;
+        case HISTORY_TIER_SECOND: return HISTORY_TIER1_PERIOD_MS;
+        case HISTORY_TIER_MINUTE: return HISTORY_TIER2_PERIOD_MS;
+        default: return 0;
+    }
+}
+
+HistoryPoint historySummary(uint8_t channel, uint8_t tier, uint32_t points) {
+    HistoryAccumulator range;
+    HistoryAccumulator means;
+    range.reset();
+    means.reset();
+    HistoryPoint p;
+    for (uint32_t age = 0; age < points && historyPoint(channel, tier, age, p); age++) {
+        if (p.mean == HISTORY_INVALID) continue;
+        range.add(p.min);
+        range.add(p.max);
+        means.add(p.mean);
+    }
+    HistoryPoint s = means.point();
+    if (range.count) {
+        s.min = range.min;
+        s.max = range.max;
+    }
+    return s;
+}
+
+size_t historyMemoryBytes() {
+    return sizeof(histories);
+}
+
+// Сводка уровня в виде "<глубина> min..max (ср mean)" или "<глубина> ---"; глубина - в ч, мин или с
+static void printSummary(uint32_t spanMs, const HistoryPoint& p) {
+    if (spanMs >= 3600000UL && spanMs % 3600000UL == 0) Serial.printf(" %uч", spanMs / 3600000UL);
+    else if (spanMs >= 60000UL) Serial.printf(" %uмин", spanMs / 60000UL);
+    else Serial.printf(" %uс", spanMs / 1000UL);
+    if (p.mean == HISTORY_INVALID) {
+        Serial.printf(" ---");
+        return;
+    }
+    Serial.printf(" %.1f..%.1f (ср %.1f)", p.min / static_cast<float>(HISTORY_SCALE),
+                  p.max / static_cast<float>(HISTORY_SCALE), p.mean / static_cast<float>(HISTORY_SCALE));
+}
+
+void reportHistory() {
+    uint32_t minutes = histories[0].tier2.written();
+    if (minutes == reportedMinutes) return;
+    reportedMinutes = minutes;
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        Serial.printf("[HIST] CH%u:", i + 1);
+        printSummary(HISTORY_TIER0_SPAN_MS, historySummary(i, HISTORY_TIER_CYCLE, historyCount(i, HISTORY_TIER_CYCLE)));
+        printSummary(HISTORY_TIER1_SPAN_MS, historySummary(i, HISTORY_TIER_SECOND, historyCount(i, HISTORY_TIER_SECOND)));
+        printSummary(HISTORY_TIER2_SPAN_MS, historySummary(i, HISTORY_TIER_MINUTE, historyCount(i, HISTORY_TIER_MINUTE)));
+        Serial.printf("\n");
+    }
+}
@@ -0,0 +1,33 @@
+// History.h
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include "ChannelState.h"
+#include "HistoryRing.h"
+
+// Уровни истории температур в RAM (периоды и глубина - HISTORY_* в Config.h)
+#define HISTORY_TIER_CYCLE  0   // Каждый цикл управления, HISTORY_TIER0_SPAN_MS
+#define HISTORY_TIER_SECOND 1   // min/max/среднее за HISTORY_TIER1_PERIOD_MS, HISTORY_TIER1_SPAN_MS
+#define HISTORY_TIER_MINUTE 2   // min/max/среднее за HISTORY_TIER2_PERIOD_MS, HISTORY_TIER2_SPAN_MS
+#define HISTORY_TIERS 3
+
+// Добавление снимка: температура каждого канала в уровень 0 и в накопители уровней 1 и 2.
+// O(1) на канал; вызывается писателем systemState (задача управления) раз в цикл.
+void historyAdd(const SystemSnapshot& snap);
+// Точка уровня tier канала с возрастом age (0 - последняя). Из любой задачи, без блокировок.
+bool historyPoint(uint8_t channel, uint8_t tier, uint32_t age, HistoryPoint& out);
+// Доступно точек на уровне.
+uint32_t historyCount(uint8_t channel, uint8_t tier);
+// Период точек уровня, мс.
+uint32_t historyPeriodMs(uint8_t tier);
+// Сводка по последним points точкам уровня: min/max по точкам, среднее - по средним точек.
+// Проход по точкам на стороне читателя (для дисплея и отчётов, не для задачи управления).
+HistoryPoint historySummary(uint8_t channel, uint8_t tier, uint32_t points);
+// Память под историю всех каналов, байт.
+size_t historyMemoryBytes();
+// Сводка по каждому уровню за всю его глубину (по умолчанию минута, час, сутки) в Serial -
+// когда появилась новая точка верхнего уровня.
+void reportHistory();
+
+#endif
@@ -0,0 +1,138 @@
+// HistoryRing.h
+#ifndef HISTORY_RING_H
+#define HISTORY_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Точка истории в 0.1 °C; HISTORY_INVALID - за интервал не было исправных отсчётов
+#define HISTORY_INVALID INT16_MIN
+#define HISTORY_SCALE 10
+
+struct HistoryPoint {
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+};
+
+// Хранение точек в кольце. Точка упаковывается при записи (pack) и распаковывается при чтении (unpack).
+// Полная точка - 6 байт (уровень 2: за минуту разброс может быть в сотни градусов).
+struct HistorySlotFull {
+    HistoryPoint p;
+    static HistorySlotFull pack(const HistoryPoint& p) { return {p}; }
+    HistoryPoint unpack() const { return p; }
+};
+
+// Одно значение - 2 байта (уровень 0: точка из одного отсчёта, min = max = mean).
+struct HistorySlotValue {
+    int16_t value;
+    static HistorySlotValue pack(const HistoryPoint& p) { return {p.mean}; }
+    HistoryPoint unpack() const { return {value, value, value}; }
+};
+
+// Среднее и отклонения min/max от него - 4 байта (уровень 1). Отклонение насыщается на 255 (25.5 °C):
+// за секунду нагреватель столько не проходит, а при насыщении min/max сужаются к среднему.
+struct HistorySlotDelta {
+    int16_t mean;
+    uint8_t below;  // mean - min
+    uint8_t above;  // max - mean
+    static uint8_t delta(int32_t d) { return static_cast<uint8_t>(d > UINT8_MAX ? UINT8_MAX : d); }
+    static HistorySlotDelta pack(const HistoryPoint& p) {
+        if (p.mean == HISTORY_INVALID) return {HISTORY_INVALID, 0, 0};
+        return {p.mean, delta(static_cast<int32_t>(p.mean) - p.min), delta(static_cast<int32_t>(p.max) - p.mean)};
+    }
+    HistoryPoint unpack() const {
+        if (mean == HISTORY_INVALID) return {HISTORY_INVALID, HISTORY_INVALID, HISTORY_INVALID};
+        return {static_cast<int16_t>(mean - below), static_cast<int16_t>(mean + above), mean};
+    }
+};
+
+// Накопитель интервала: минимум, максимум, сумма и число исправных отсчётов.
+// Добавление и слияние - O(1); слияние накопителей точное (среднее не усредняется повторно).
+struct HistoryAccumulator {
+    int32_t sum;
+    int16_t min;
+    int16_t max;
+    uint16_t count;
+
+    void reset() {
+        sum = 0;
+        min = INT16_MAX;
+        max = INT16_MIN;
+        count = 0;
+    }
+
+    void add(int16_t v) {
+        if (v == HISTORY_INVALID) return;
+        sum += v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+        count++;
+    }
+
+    void merge(const HistoryAccumulator& other) {
+        if (!other.count) return;
+        sum += other.sum;
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+        count += other.count;
+    }
+
+    HistoryPoint point() const {
+        HistoryPoint p;
+        if (!count) {
+            p.min = p.max = p.mean = HISTORY_INVALID;
+        } else {
+            p.min = min;
+            p.max = max;
+            // Округление к ближайшему и для отрицательных сумм
+            p.mean = static_cast<int16_t>(sum >= 0 ? (sum + count / 2) / count : (sum - count / 2) / count);
+        }
+        return p;
+    }
+};
+
+// Кольцо точек одного уровня истории. Пишет одна задача, читателей сколько угодно:
+// прочитанная точка проверяется повторным чтением счётчика записей (как в SampleRing).
+// N - любое, индекс берётся по модулю; Slot - формат хранения точки (HistorySlot*).
+template <uint32_t N, typename Slot = HistorySlotFull>
+class HistoryRing {
+    static_assert(N >= 2, "Уровень истории - не меньше двух точек");
+public:
+    // Добавление точки (только из задачи-писателя).
+    void push(const HistoryPoint& p) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);  // См. SampleRing::push
+        slots[h % N] = Slot::pack(p);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Точка с возрастом age (0 - последняя). false - такой точки уже (или ещё) нет.
+    bool get(uint32_t age, HistoryPoint& out) const {
+        for (;;) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (age >= h || age >= N - 1) return false;
+            uint32_t index = h - 1 - age;
+            out = slots[index % N].unpack();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (head.load(std::memory_order_relaxed) - index <= N - 1) return true;
+            // Точка перезаписана во время копирования; с новым счётчиком возраст сдвинется - повторяем
+        }
+    }
+
+    // Доступно точек для чтения.
+    uint32_t count() const {
+        uint32_t h = head.load(std::memory_order_acquire);
+        return h < N - 1 ? h : N - 1;
+    }
+    // Всего добавлено точек (для читателей, ждущих новую).
+    uint32_t written() const { return head.load(std::memory_order_acquire); }
+
+    static constexpr uint32_t capacity() { return N; }
+
+private:
+    Slot slots[N];
+    std::atomic<uint32_t> head{0};
+};
+
+#endif
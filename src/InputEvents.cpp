@@ -0,0 +1,130 @@
+// InputEvents.cpp
+// Ввод с энкодеров через прерывания GPIO и очередь типизированных событий.
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "InputEvents.h"
+#include "ChannelTable.h"
+
+EncButton encoders[NUM_CHANNELS];
+QueueHandle_t inputQueue = NULL;
+
+static TaskHandle_t inputScanTask = NULL;
+// Щелчки энкодеров со знаком, накопленные прерыванием с прошлого прохода задачи распознавания
+static std::atomic<int32_t> turnSteps[NUM_CHANNELS];
+// Общие поля EncButton (флаги и буфер поворотов) трогают и прерывание, и tick() задачи
+static portMUX_TYPE encoderMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Фронт на линии энкодера: поворот разбирается сразу и считается в turnSteps канала,
+// задача распознавания только будится, чтобы выдать событие. arg - номер канала.
+static void IRAM_ATTR encoderISR(void* arg) {
+    uint32_t i = reinterpret_cast<uintptr_t>(arg);
+    portENTER_CRITICAL_ISR(&encoderMux);
+    int8_t step = encoders[i].tickISR();
+    portEXIT_CRITICAL_ISR(&encoderMux);
+    if (step) turnSteps[i].fetch_add(step, std::memory_order_relaxed);
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(inputScanTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+// Фронт на кнопке: будим задачу, дальше она опрашивает кнопку сама, пока та занята.
+static void IRAM_ATTR buttonISR(void* arg) {
+    (void)arg;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(inputScanTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void postEvent(InputEventType type, uint8_t channel, int8_t steps) {
+    InputEvent ev;
+    ev.type = type;
+    ev.channel = channel;
+    ev.steps = steps;
+    ev.timeMs = millis();
+    if (xQueueSend(inputQueue, &ev, 0) != pdTRUE) {
+        Serial.println("[INPUT] Очередь событий переполнена, событие потеряно");
+    }
+}
+
+// Поворот канала на все щелчки с прошлого прохода, кусками в пределах int8_t
+static void postTurn(uint8_t channel) {
+    int32_t steps = turnSteps[channel].exchange(0, std::memory_order_relaxed);
+    while (steps) {
+        int8_t chunk = static_cast<int8_t>(constrain(steps, (int32_t)INT8_MIN, (int32_t)INT8_MAX));
+        postEvent(INPUT_TURN, channel, chunk);
+        steps -= chunk;
+    }
+}
+
+// Прерывания энкодеров подключаются из задачи распознавания: служба прерываний GPIO
+// ставится на ядро вызывающей задачи (UI_TASK_CORE), и фронты не прерывают задачу управления.
+static void attachEncoderInterrupts() {
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        const ChannelDescriptor& desc = CHANNEL_TABLE[i];
+        void* arg = reinterpret_cast<void*>(static_cast<uintptr_t>(i));
+        attachInterruptArg(desc.encDtPin, encoderISR, arg, CHANGE);
+        attachInterruptArg(desc.encClkPin, encoderISR, arg, CHANGE);
+        attachInterruptArg(desc.encSwPin, buttonISR, NULL, CHANGE);
+    }
+}
+
+// Задача распознавания: tick() всех энкодеров только после прерывания или пока кнопки заняты.
+// Сама режимы не трогает и мьютексы не берёт.
+static void TaskInputScan(void *pvParameters) {
+    bool comboLatched = false;  // Комбинация уже выдана, ждём отпускания обеих кнопок
+    bool busy = false;
+
+    // Дескриптор нужен прерываниям до того, как xTaskCreatePinnedToCore() вернёт его в beginInput()
+    inputScanTask = xTaskGetCurrentTaskHandle();
+    attachEncoderInterrupts();
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, busy ? pdMS_TO_TICKS(INPUT_POLL_MS) : portMAX_DELAY);
+        busy = false;
+        for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+            EncButton& enc = encoders[i];
+            portENTER_CRITICAL(&encoderMux);
+            enc.tick();
+            portEXIT_CRITICAL(&encoderMux);
+            // Флаг turn() EncButton сливает все щелчки между проходами в один - шаги берутся из счётчика
+            postTurn(i);
+            if (enc.click()) postEvent(INPUT_CLICK, i, 0);
+            if (enc.hold()) {
+#if NUM_CHANNELS > INPUT_COMBO_SECOND
+                bool comboKey = (i == INPUT_COMBO_FIRST || i == INPUT_COMBO_SECOND);
+                uint8_t other = (i == INPUT_COMBO_FIRST) ? INPUT_COMBO_SECOND : INPUT_COMBO_FIRST;
+                if (comboKey && encoders[other].pressing()) {
+                    if (!comboLatched) postEvent(INPUT_COMBO_HOLD, i, 0);
+                    comboLatched = true;
+                } else if (!comboLatched) {
+                    postEvent(INPUT_HOLD, i, 0);
+                }
+#else
+                postEvent(INPUT_HOLD, i, 0);
+#endif
+            }
+            if (enc.busy()) busy = true;
+        }
+#if NUM_CHANNELS > INPUT_COMBO_SECOND
+        if (comboLatched && !encoders[INPUT_COMBO_FIRST].pressing() && !encoders[INPUT_COMBO_SECOND].pressing()) {
+            comboLatched = false;
+        }
+#endif
+    }
+}
+
+void beginInput() {
+    inputQueue = xQueueCreate(INPUT_QUEUE_LENGTH, sizeof(InputEvent));
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        const ChannelDescriptor& desc = CHANNEL_TABLE[i];
+        EncButton& enc = encoders[i];
+        enc.init(desc.encDtPin, desc.encClkPin, desc.encSwPin);
+        enc.setEncISR(true);  // Энкодер обрабатывается только в прерывании
+        turnSteps[i].store(0);
+    }
+    // Прерывания подключит сама задача (attachEncoderInterrupts) - на своём ядре
+    xTaskCreatePinnedToCore(TaskInputScan, "InputScan", 2048, NULL, INPUT_TASK_PRIORITY, NULL, UI_TASK_CORE);
+}
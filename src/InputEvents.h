@@ -0,0 +1,42 @@
+// InputEvents.h
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <Arduino.h>
+#include <EncButton.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "Config.h"
+
+// Типы событий ввода
+enum InputEventType : uint8_t {
+    INPUT_TURN,        // Поворот энкодера на steps щелчков (знак - направление)
+    INPUT_CLICK,       // Одиночный клик кнопки энкодера
+    INPUT_HOLD,        // Удержание кнопки энкодера
+    INPUT_COMBO_HOLD   // Удержание кнопок INPUT_COMBO_FIRST и INPUT_COMBO_SECOND одновременно
+};
+
+// Каналы, чьё совместное удержание даёт INPUT_COMBO_HOLD (вместо двух INPUT_HOLD)
+#define INPUT_COMBO_FIRST 0
+#define INPUT_COMBO_SECOND 2
+
+// Событие ввода от энкодера канала channel.
+struct InputEvent {
+    InputEventType type;
+    uint8_t channel;
+    int8_t steps;      // Только для INPUT_TURN
+    uint32_t timeMs;   // millis() в момент распознавания
+};
+
+// Энкодеры каналов; пины назначаются в beginInput() по CHANNEL_TABLE
+extern EncButton encoders[NUM_CHANNELS];
+// Очередь событий ввода; читает задача режимов (TaskInputEvents в main.cpp)
+extern QueueHandle_t inputQueue;
+
+// Настройка энкодеров по таблице каналов, прерываний GPIO и задачи распознавания событий.
+// Повороты ловятся в прерывании (tickISR) и считаются по щелчкам, кнопки - по фронтам; задача просыпается
+// только по прерываниям и, пока какая-либо кнопка занята (нажата или ждёт таймаута), раз в INPUT_POLL_MS.
+// Прерывания подключаются из задачи распознавания и обслуживаются на UI_TASK_CORE.
+void beginInput();
+
+#endif
@@ -0,0 +1,81 @@
+// LcdFrameBuffer.cpp
+// Теневой буфер LCD: вывод только изменившихся ячеек.
+#include <Arduino.h>
+#include <string.h>
+#include "LcdFrameBuffer.h"
+
+LcdFrameBuffer::LcdFrameBuffer(LiquidCrystal_PCF8574& lcd) : lcd(lcd), fullRedraw(true) {
+    memset(back, ' ', sizeof(back));
+    memset(front, ' ', sizeof(front));
+    memset(&frameStats, 0, sizeof(frameStats));
+}
+
+void LcdFrameBuffer::write(uint8_t col, uint8_t row, const char* text) {
+    if (row >= DISPLAY_HEIGHT) return;
+    while (*text && col < DISPLAY_WIDTH) back[row][col++] = *text++;
+}
+
+void LcdFrameBuffer::writeLine(uint8_t row, const char* text) {
+    if (row >= DISPLAY_HEIGHT) return;
+    uint8_t col = 0;
+    while (*text && col < DISPLAY_WIDTH) back[row][col++] = *text++;
+    while (col < DISPLAY_WIDTH) back[row][col++] = ' ';
+}
+
+void LcdFrameBuffer::fill(char c) {
+    memset(back, c, sizeof(back));
+}
+
+uint16_t LcdFrameBuffer::flush() {
+    uint16_t bytes = 0;
+    uint16_t runs = 0;
+    uint16_t wire = 0;
+    for (uint8_t row = 0; row < DISPLAY_HEIGHT; row++) {
+        uint8_t col = 0;
+        while (col < DISPLAY_WIDTH) {
+            if (!fullRedraw && back[row][col] == front[row][col]) {
+                col++;
+                continue;
+            }
+            // Начало отрезка; продолжаем, пока изменения не прервутся хотя бы на две ячейки
+            uint8_t start = col;
+            uint8_t end = col + 1;
+            while (end < DISPLAY_WIDTH) {
+                if (fullRedraw || back[row][end] != front[row][end]) {
+                    end++;
+                } else if (end + 1 < DISPLAY_WIDTH && back[row][end + 1] != front[row][end + 1]) {
+                    end += 2;  // Одна неизменная ячейка внутри отрезка
+                } else {
+                    break;
+                }
+            }
+            uint8_t len = end - start;
+            lcd.setCursor(start, row);
+            lcd.writeBuffer(reinterpret_cast<const uint8_t*>(&back[row][start]), len);
+            memcpy(&front[row][start], &back[row][start], len);
+            bytes += 1 + len;
+            // setCursor - отдельная транзакция (адрес + 4 байта), символы - пачками по charsPerTransmission()
+            uint8_t perTx = lcd.charsPerTransmission();
+            wire += 5 + 4 * len + (len + perTx - 1) / perTx;
+            runs++;
+            col = end;
+        }
+    }
+    fullRedraw = false;
+
+    if (bytes) {
+        frameStats.frames++;
+        frameStats.totalBytes += bytes;
+        frameStats.wireBytes += wire;
+        frameStats.lastBytes = bytes;
+        frameStats.lastRuns = runs;
+        if (bytes > frameStats.maxBytes) frameStats.maxBytes = bytes;
+    }
+    return bytes;
+}
+
+LcdFrameStats LcdFrameBuffer::stats(bool reset) {
+    LcdFrameStats copy = frameStats;
+    if (reset) memset(&frameStats, 0, sizeof(frameStats));
+    return copy;
+}
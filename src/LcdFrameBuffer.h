@@ -0,0 +1,50 @@
+// LcdFrameBuffer.h
+#ifndef LCD_FRAME_BUFFER_H
+#define LCD_FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include <LiquidCrystal_PCF8574.h>
+#include "Config.h"
+
+// Статистика вывода на LCD (байты HD44780: символы плюс команды установки курсора).
+struct LcdFrameStats {
+    uint32_t frames;        // Вызовов flush() с изменениями
+    uint32_t totalBytes;    // Суммарно байт за все кадры
+    uint32_t wireBytes;     // Суммарно байт на шине I2C (с адресами транзакций)
+    uint16_t lastBytes;     // Байт в последнем кадре
+    uint16_t maxBytes;      // Максимум байт за кадр
+    uint16_t lastRuns;      // Отрезков (setCursor) в последнем кадре
+};
+
+// Теневой буфер экрана 20x4. Отрисовка пишет в back, flush() сравнивает его с тем,
+// что уже на дисплее (front), и отправляет только изменившиеся отрезки строк -
+// по одной команде setCursor на отрезок, символы отрезка уходят пачкой через writeBuffer().
+// Отрезки, разделённые одной неизменной ячейкой, объединяются: повтор символа стоит
+// не дороже новой команды курсора.
+class LcdFrameBuffer {
+public:
+    explicit LcdFrameBuffer(LiquidCrystal_PCF8574& lcd);
+
+    // Запись текста с позиции (col, row); выходящее за край строки отбрасывается.
+    void write(uint8_t col, uint8_t row, const char* text);
+    // Вся строка: текст дополняется пробелами до DISPLAY_WIDTH.
+    void writeLine(uint8_t row, const char* text);
+    // Заполнение всего буфера символом.
+    void fill(char c = ' ');
+    // Содержимое дисплея неизвестно (после lcd.begin()/clear()): следующий flush() перерисует всё.
+    void invalidate() { fullRedraw = true; }
+    // Отправка изменений на дисплей. Возвращает число отправленных байт HD44780.
+    uint16_t flush();
+
+    // Копия статистики; при reset обнуляет накопленные значения.
+    LcdFrameStats stats(bool reset);
+
+private:
+    LiquidCrystal_PCF8574& lcd;
+    char back[DISPLAY_HEIGHT][DISPLAY_WIDTH];   // Желаемое содержимое
+    char front[DISPLAY_HEIGHT][DISPLAY_WIDTH];  // Что сейчас на дисплее
+    bool fullRedraw;
+    LcdFrameStats frameStats;
+};
+
+#endif
@@ -0,0 +1,134 @@
+// MAX6675Bus.cpp
+// Параллельное чтение нескольких MAX6675 с общим CLK за один пакет тактов.
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "MAX6675Bus.h"
+#include "FastGPIO.h"
+
+MAX6675Bus::MAX6675Bus(uint8_t clkPin)
+    : clkPin(clkPin), count(0),
+      clkMask(gpioMask(clkPin)), clkSetReg(gpioSetReg(clkPin)), clkClearReg(gpioClearReg(clkPin))
+{
+}
+
+int MAX6675Bus::addDevice(uint8_t dataPin, uint8_t csPin) {
+    if (count >= NUM_CHANNELS) return -1;
+    uint8_t i = count++;
+    dataPins[i] = dataPin;
+    csPins[i] = csPin;
+    raw[i] = 0xFFFF;  // До первого чтения считаем датчик недоступным
+    stamp[i] = 0;
+
+    // Маски регистров GPIO вычисляются один раз при регистрации
+    dataMask[i] = gpioMask(dataPin);
+    dataHigh[i] = gpioHighBank(dataPin);
+    csMask[i] = gpioMask(csPin);
+    csHigh[i] = gpioHighBank(csPin);
+    return i;
+}
+
+void MAX6675Bus::begin() {
+    pinMode(clkPin, OUTPUT);
+    digitalWrite(clkPin, LOW);
+    for (uint8_t i = 0; i < count; i++) {
+        // У GPIO34..39 (DO в CHANNEL_TABLE) внутренней подтяжки нет: нужна внешняя 10 кОм к 3.3 В,
+        // иначе отключённый модуль читается шумом, а не 0xFFFF.
+        pinMode(dataPins[i], INPUT);
+        pinMode(csPins[i], OUTPUT);
+        digitalWrite(csPins[i], HIGH);
+    }
+}
+
+uint32_t MAX6675Bus::read(uint32_t mask) {
+    mask &= allMask();
+    if (!mask) return 0;
+#ifdef MAX6675_DIGITAL_IO
+    readDigital(mask);
+#else
+    readFast(mask);
+#endif
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1UL << i)) stamp[i] = now;
+    }
+    return mask;
+}
+
+void MAX6675Bus::readDigital(uint32_t mask) {
+    uint16_t data[NUM_CHANNELS] = {0};
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1UL << i)) digitalWrite(csPins[i], LOW);
+    }
+    for (int bit = 0; bit < 16; bit++) {
+        digitalWrite(clkPin, HIGH);
+#ifdef MAX6675_DELAY
+        delayMicroseconds(MAX6675_DELAY);
+#endif
+        // На каждом фронте снимаем очередной бит со всех линий DO
+        for (uint8_t i = 0; i < count; i++) {
+            data[i] <<= 1;
+            if (digitalRead(dataPins[i])) data[i] |= 1;
+        }
+        digitalWrite(clkPin, LOW);
+#ifdef MAX6675_DELAY
+        delayMicroseconds(MAX6675_DELAY);
+#endif
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1UL << i)) {
+            digitalWrite(csPins[i], HIGH);
+            raw[i] = data[i];
+        }
+    }
+}
+
+// Тот же пакет через регистры W1TS/W1TC/IN: все выбранные CS переключаются одной записью,
+// а все линии DO снимаются одним чтением регистра на каждом фронте.
+void IRAM_ATTR MAX6675Bus::readFast(uint32_t mask) {
+    uint16_t data[NUM_CHANNELS] = {0};
+    uint32_t csLow = 0, csHighBank = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!(mask & (1UL << i))) continue;
+        if (csHigh[i]) csHighBank |= csMask[i];
+        else csLow |= csMask[i];
+    }
+
+    if (csLow) REG_WRITE(GPIO_OUT_W1TC_REG, csLow);
+    if (csHighBank) REG_WRITE(GPIO_OUT1_W1TC_REG, csHighBank);
+    gpioTimingGuard();
+    for (int bit = 0; bit < 16; bit++) {
+        REG_WRITE(clkSetReg, clkMask);
+        gpioTimingGuard();
+        uint32_t inLow = REG_READ(GPIO_IN_REG);
+        uint32_t inHigh = REG_READ(GPIO_IN1_REG);
+        for (uint8_t i = 0; i < count; i++) {
+            uint32_t in = dataHigh[i] ? inHigh : inLow;
+            data[i] = (data[i] << 1) | ((in & dataMask[i]) ? 1 : 0);
+        }
+        REG_WRITE(clkClearReg, clkMask);
+        gpioTimingGuard();
+    }
+    if (csLow) REG_WRITE(GPIO_OUT_W1TS_REG, csLow);
+    if (csHighBank) REG_WRITE(GPIO_OUT1_W1TS_REG, csHighBank);
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1UL << i)) raw[i] = data[i];
+    }
+}
+
+#ifdef MAX6675_BENCHMARK
+void benchmarkSensorBus(MAX6675Bus& bus, int iterations) {
+    unsigned long start = micros();
+    for (int i = 0; i < iterations; i++) bus.readDigital(bus.allMask());
+    unsigned long digitalTime = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < iterations; i++) bus.readFast(bus.allMask());
+    unsigned long fastTime = micros() - start;
+
+    Serial.printf("[BENCH] MAX6675 x%u: digitalWrite %.2f мкс/пакет, регистры %.2f мкс/пакет\n",
+                  bus.size(), (float)digitalTime / iterations, (float)fastTime / iterations);
+}
+#endif
@@ -0,0 +1,70 @@
+// MAX6675Bus.h
+#ifndef MAX6675_BUS_H
+#define MAX6675_BUS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "SampleRing.h"
+#include "TemperatureSensor.h"
+
+// Драйвер группы MAX6675, висящих на общей линии CLK.
+// Все CS опускаются одновременно, и на каждом из 16 тактов CLK опрашиваются
+// сразу все линии DO, поэтому полный опрос стоит столько же, сколько чтение одного датчика.
+class MAX6675Bus : public TemperatureSensor {
+public:
+    explicit MAX6675Bus(uint8_t clkPin);
+
+    // Регистрация датчика с пинами DO и CS (до begin()). Возвращает его индекс на шине
+    // или -1, если шина уже заполнена (не более NUM_CHANNELS датчиков).
+    int addDevice(uint8_t dataPin, uint8_t csPin);
+
+    // Настройка пинов. Вызывается один раз из setup().
+    void begin() override;
+    // Один пакет из 16 тактов: считывает сырые слова датчиков из маски (бит i - датчик i).
+    // Возвращает маску датчиков, получивших новое значение (для этой шины - всю запрошенную).
+    // По умолчанию работает через регистры GPIO; MAX6675_DIGITAL_IO включает путь через digitalWrite/digitalRead.
+    uint32_t read(uint32_t mask) override;
+    // Реализации пакета; доступны отдельно для сравнения в benchmarkSensorBus().
+    void readDigital(uint32_t mask);
+    void readFast(uint32_t mask);
+
+    uint8_t size() const override { return count; }
+    RawSample getSample(uint8_t index) const override { return toSample(raw[index], stamp[index]); }
+    uint32_t conversionMs() const override { return MAX6675_CONVERSION_MS; }
+    // Сырое 16-битное слово датчика из последнего пакета.
+    uint16_t getRaw(uint8_t index) const { return raw[index]; }
+
+    // Разбор слова MAX6675 в отсчёт кольцевого буфера.
+    static RawSample toSample(uint16_t word, TickType_t tick) {
+        RawSample s;
+        s.rawCounts = word >> 3;
+        s.status = (word == 0xFFFF) ? SAMPLE_STATUS_NO_DEVICE : ((word & 0b100) ? SAMPLE_STATUS_OPEN_TC : 0);
+        s.tick = tick;
+        return s;
+    }
+
+private:
+    uint8_t clkPin;
+    uint8_t dataPins[NUM_CHANNELS];
+    uint8_t csPins[NUM_CHANNELS];
+    uint8_t count;
+    uint16_t raw[NUM_CHANNELS];
+    TickType_t stamp[NUM_CHANNELS];
+
+    // Маски регистров GPIO, вычисляются один раз в конструкторе и addDevice()
+    uint32_t clkMask;
+    uint32_t clkSetReg;
+    uint32_t clkClearReg;
+    uint32_t csMask[NUM_CHANNELS];
+    bool csHigh[NUM_CHANNELS];
+    uint32_t dataMask[NUM_CHANNELS];
+    bool dataHigh[NUM_CHANNELS];
+};
+
+#ifdef MAX6675_BENCHMARK
+// Замер времени пакета (мкс) для обоих путей с выводом в Serial.
+void benchmarkSensorBus(MAX6675Bus& bus, int iterations);
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+// MAX6675SpiBus.cpp
+// Чтение MAX6675 через очередь транзакций spi_master (DMA), без ожидания в задаче управления.
+#include <Arduino.h>
+#include <string.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "MAX6675SpiBus.h"
+
+MAX6675SpiBus::MAX6675SpiBus(uint8_t clkPin, uint8_t misoPin)
+    : clkPin(clkPin), misoPin(misoPin), count(0), ready(false)
+{
+}
+
+int MAX6675SpiBus::addDevice(uint8_t csPin) {
+    if (count >= NUM_CHANNELS) return -1;
+    uint8_t i = count++;
+    csPins[i] = csPin;
+    raw[i] = 0xFFFF;  // До первого чтения считаем датчик недоступным
+    stamp[i] = 0;
+    queuedAt[i] = 0;
+    devices[i] = NULL;
+    rxBuffers[i] = NULL;
+    pending[i] = false;
+    return i;
+}
+
+void MAX6675SpiBus::begin() {
+    spi_bus_config_t busConf;
+    memset(&busConf, 0, sizeof(busConf));
+    busConf.mosi_io_num = -1;         // MAX6675 только передаёт данные
+    busConf.miso_io_num = misoPin;
+    busConf.sclk_io_num = clkPin;
+    busConf.quadwp_io_num = -1;
+    busConf.quadhd_io_num = -1;
+    busConf.max_transfer_sz = 4;
+    if (spi_bus_initialize(TC_SPI_HOST, &busConf, SPI_DMA_CH_AUTO) != ESP_OK) {
+        Serial.println("[SPI] Не удалось инициализировать шину термопар!");
+        return;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        spi_device_interface_config_t devConf;
+        memset(&devConf, 0, sizeof(devConf));
+        devConf.clock_speed_hz = TC_SPI_CLOCK_HZ;
+        devConf.mode = 0;
+        devConf.spics_io_num = csPins[i];
+        devConf.queue_size = 1;
+        if (spi_bus_add_device(TC_SPI_HOST, &devConf, &devices[i]) != ESP_OK) {
+            Serial.printf("[SPI] CH%d: Не удалось добавить датчик\n", i + 1);
+            return;
+        }
+
+        rxBuffers[i] = static_cast<uint8_t*>(heap_caps_malloc(4, MALLOC_CAP_DMA));
+        if (!rxBuffers[i]) {
+            Serial.printf("[SPI] CH%d: Нет DMA-памяти под буфер\n", i + 1);
+            return;
+        }
+        memset(&transactions[i], 0, sizeof(spi_transaction_t));
+        transactions[i].length = 16;
+        transactions[i].rxlength = 16;
+        transactions[i].tx_buffer = NULL;
+        transactions[i].rx_buffer = rxBuffers[i];
+    }
+    ready = true;
+}
+
+uint32_t MAX6675SpiBus::read(uint32_t mask) {
+    if (!ready) return 0;
+
+    uint32_t fresh = 0;
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < count; i++) {
+        // Забираем результат, если DMA уже закончил; ожидания нет (таймаут 0)
+        if (pending[i]) {
+            spi_transaction_t* done = NULL;
+            if (spi_device_get_trans_result(devices[i], &done, 0) == ESP_OK) {
+                raw[i] = (static_cast<uint16_t>(rxBuffers[i][0]) << 8) | rxBuffers[i][1];
+                stamp[i] = queuedAt[i];
+                pending[i] = false;
+                fresh |= 1UL << i;
+            }
+        }
+        // Следующее чтение ставим в очередь, только когда предыдущее забрано
+        if ((mask & (1UL << i)) && !pending[i] &&
+            spi_device_queue_trans(devices[i], &transactions[i], 0) == ESP_OK) {
+            queuedAt[i] = now;
+            pending[i] = true;
+        }
+    }
+    return fresh;
+}
@@ -0,0 +1,49 @@
+// MAX6675SpiBus.h
+#ifndef MAX6675_SPI_BUS_H
+#define MAX6675_SPI_BUS_H
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "MAX6675Bus.h"
+
+// Группа MAX6675 на аппаратном SPI ESP32 (MISO общий, CS у каждого модуля свой).
+// Чтения ставятся в очередь драйвера spi_master и выполняются DMA без участия CPU;
+// задача управления только забирает готовые результаты.
+class MAX6675SpiBus : public TemperatureSensor {
+public:
+    MAX6675SpiBus(uint8_t clkPin, uint8_t misoPin);
+
+    // Регистрация датчика с пином CS (до begin()). Возвращает индекс датчика или -1, если мест нет.
+    int addDevice(uint8_t csPin);
+
+    // Инициализация шины SPI и устройств. Вызывается один раз из setup().
+    void begin() override;
+    // Забирает завершённые транзакции предыдущих вызовов и ставит в очередь чтения датчиков из маски.
+    // Возвращает маску датчиков, чьи результаты забраны; данные отстают на один цикл задачи управления.
+    uint32_t read(uint32_t mask) override;
+
+    uint8_t size() const override { return count; }
+    // Метка отсчёта - тик, в который транзакция была поставлена в очередь (момент защёлкивания значения).
+    RawSample getSample(uint8_t index) const override { return MAX6675Bus::toSample(raw[index], stamp[index]); }
+    uint32_t conversionMs() const override { return MAX6675_CONVERSION_MS; }
+    uint16_t getRaw(uint8_t index) const { return raw[index]; }
+
+private:
+    uint8_t clkPin;
+    uint8_t misoPin;
+    uint8_t csPins[NUM_CHANNELS];
+    uint8_t count;
+    bool ready;                       // Шина успешно инициализирована
+    uint16_t raw[NUM_CHANNELS];
+    TickType_t stamp[NUM_CHANNELS];
+    TickType_t queuedAt[NUM_CHANNELS];
+
+    spi_device_handle_t devices[NUM_CHANNELS];
+    spi_transaction_t transactions[NUM_CHANNELS];
+    uint8_t* rxBuffers[NUM_CHANNELS]; // Буферы в DMA-памяти
+    bool pending[NUM_CHANNELS];       // Транзакция в очереди, результат не забран
+};
+
+#endif
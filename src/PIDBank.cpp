@@ -0,0 +1,87 @@
+// PIDBank.cpp
+// Пакетный расчёт PID всех каналов за один проход по массивам.
+#include <Arduino.h>
+#include "PIDBank.h"
+
+PIDBank pidBank;
+
+PIDBank::PIDBank() : reverseMask(0), rateMask(0), pendingMask(0), startedMask(0) {
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        setpoint[i] = input[i] = prevInput[i] = integral[i] = output[i] = 0;
+        minOut[i] = 0;
+        maxOut[i] = static_cast<q16_t>(PWM_MAX_DUTY) << 16;
+        kp[i] = PID_KP;
+        ki[i] = PID_KI;
+        kd[i] = PID_KD;
+        dtMs[i] = 2 * CONTROL_PERIOD_MS;
+        lastTick[i] = 0;
+        updateGains(i);
+    }
+}
+
+void PIDBank::updateGains(uint8_t i) {
+    float dtS = dtMs[i] / 1000.0f;
+    kpQ[i] = floatToQ16(kp[i]);
+    kiDtQ[i] = floatToQ16(ki[i] * dtS);
+    kdDtQ[i] = floatToQ16(kd[i] / dtS);
+}
+
+void PIDBank::setTunings(uint8_t i, float kp, float ki, float kd) {
+    this->kp[i] = kp;
+    this->ki[i] = ki;
+    this->kd[i] = kd;
+    updateGains(i);
+}
+
+void PIDBank::setLimits(uint8_t i, int16_t minOutput, int16_t maxOutput) {
+    minOut[i] = static_cast<q16_t>(minOutput) << 16;
+    maxOut[i] = static_cast<q16_t>(maxOutput) << 16;
+}
+
+void PIDBank::setDirection(uint8_t i, bool direction) {
+    if (direction) reverseMask |= 1UL << i;
+    else reverseMask &= ~(1UL << i);
+}
+
+void PIDBank::setMode(uint8_t i, bool mode) {
+    if (mode) rateMask |= 1UL << i;
+    else rateMask &= ~(1UL << i);
+}
+
+void PIDBank::reset(uint8_t i) {
+    integral[i] = 0;
+    prevInput[i] = input[i];
+}
+
+void PIDBank::setInput(uint8_t i, float value, TickType_t tick) {
+    uint32_t bit = 1UL << i;
+    if (startedMask & bit) {
+        if (tick == lastTick[i]) return;  // Тот же отсчёт
+        uint32_t dt = (TickType_t)(tick - lastTick[i]) * portTICK_PERIOD_MS;
+        if (dt > 0 && dt != dtMs[i]) {
+            dtMs[i] = dt;
+            updateGains(i);
+        }
+    }
+    // Вне расчёта (STANDBY, автонастройка) отсчёты не доходят до update(): предыдущий вход ведётся здесь,
+    // иначе первый шаг после возврата в работу взял бы производную от давно устаревшего входа.
+    // Самый первый отсчёт сам себе предыдущий - без броска D при старте.
+    if (!(startedMask & bit)) prevInput[i] = floatToQ16(value);
+    else if (pendingMask & bit) prevInput[i] = input[i];
+    lastTick[i] = tick;
+    startedMask |= bit;
+    input[i] = floatToQ16(value);
+    pendingMask |= bit;
+}
+
+uint32_t PIDBank::update(uint32_t mask) {
+    uint32_t todo = mask & pendingMask;
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        uint32_t bit = 1UL << i;
+        if (!(todo & bit)) continue;
+        output[i] = q16PidStep(setpoint[i], input[i], prevInput[i], integral[i], kpQ[i], kiDtQ[i], kdDtQ[i],
+                               minOut[i], maxOut[i], reverseMask & bit, rateMask & bit);
+    }
+    pendingMask &= ~todo;
+    return todo;
+}
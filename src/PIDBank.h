@@ -0,0 +1,89 @@
+// PIDBank.h
+#ifndef PID_BANK_H
+#define PID_BANK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "FixedPID.h"
+
+// Пакетный PID для всех каналов (структура массивов).
+// Уставки, входы, интегральные суммы, предыдущие входы и коэффициенты лежат в отдельных
+// непрерывных массивах, а update() обсчитывает все каналы с новыми отсчётами за один проход.
+// Шаг расчёта - то же ядро q16PidStep(), что у FixedPID (Q16.16 с насыщением).
+class PIDBank {
+public:
+    // Представление одного канала банка с интерфейсом настройки, как у FixedPID.
+    class Channel {
+    public:
+        Channel(PIDBank* bank, uint8_t index) : bank(bank), index(index) {}
+        void setTunings(float kp, float ki, float kd) { bank->setTunings(index, kp, ki, kd); }
+        void setLimits(int16_t minOutput, int16_t maxOutput) { bank->setLimits(index, minOutput, maxOutput); }
+        void setDirection(bool direction) { bank->setDirection(index, direction); }
+        void setMode(bool mode) { bank->setMode(index, mode); }
+        void reset() { bank->reset(index); }
+        void setSetpoint(float setpoint) { bank->setSetpoint(index, setpoint); }
+        void setInput(float input, TickType_t tick) { bank->setInput(index, input, tick); }
+        int getOutput() const { return bank->getOutput(index); }
+        float getIntegral() const { return q16ToFloat(bank->integral[index]); }
+        float getKp() const { return bank->kp[index]; }
+        float getKi() const { return bank->ki[index]; }
+        float getKd() const { return bank->kd[index]; }
+        int16_t getMaxOutput() const { return bank->maxOut[index] >> 16; }
+        bool getDirection() const { return bank->reverseMask & (1UL << index); }
+        bool getMode() const { return bank->rateMask & (1UL << index); }
+    private:
+        PIDBank* bank;
+        uint8_t index;
+    };
+
+    PIDBank();
+
+    void setTunings(uint8_t i, float kp, float ki, float kd);
+    void setLimits(uint8_t i, int16_t minOutput, int16_t maxOutput);
+    void setDirection(uint8_t i, bool direction);
+    void setMode(uint8_t i, bool mode);
+    void reset(uint8_t i);
+
+    void setSetpoint(uint8_t i, float setpoint) { this->setpoint[i] = floatToQ16(setpoint); }
+    // Новый отсчёт канала с меткой времени; шаг dt берётся из интервала между метками.
+    void setInput(uint8_t i, float input, TickType_t tick);
+
+    // Расчёт всех каналов из маски, получивших новый вход после прошлого расчёта.
+    // Возвращает маску пересчитанных каналов.
+    uint32_t update(uint32_t mask);
+
+    int getOutput(uint8_t i) const { return (output[i] + (Q16_ONE / 2)) >> 16; }
+    float getInputValue(uint8_t i) const { return q16ToFloat(input[i]); }
+    float getSetpointValue(uint8_t i) const { return q16ToFloat(setpoint[i]); }
+
+private:
+    // Горячие данные расчёта
+    q16_t setpoint[NUM_CHANNELS];
+    q16_t input[NUM_CHANNELS];
+    q16_t prevInput[NUM_CHANNELS];
+    q16_t integral[NUM_CHANNELS];
+    q16_t output[NUM_CHANNELS];
+    q16_t kpQ[NUM_CHANNELS];
+    q16_t kiDtQ[NUM_CHANNELS];   // Ki * dt
+    q16_t kdDtQ[NUM_CHANNELS];   // Kd / dt
+    q16_t minOut[NUM_CHANNELS];
+    q16_t maxOut[NUM_CHANNELS];
+    uint32_t reverseMask;        // Каналы с направлением REVERSE
+    uint32_t rateMask;           // Каналы в режиме ON_RATE
+    uint32_t pendingMask;        // Каналы с новым входом
+
+    // Холодные данные (пересчёт коэффициентов)
+    float kp[NUM_CHANNELS];
+    float ki[NUM_CHANNELS];
+    float kd[NUM_CHANNELS];
+    uint32_t dtMs[NUM_CHANNELS];
+    TickType_t lastTick[NUM_CHANNELS];
+    uint32_t startedMask;        // Каналы, у которых уже был отсчёт
+
+    void updateGains(uint8_t i);
+};
+
+extern PIDBank pidBank;
+
+#endif
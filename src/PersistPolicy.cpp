@@ -0,0 +1,44 @@
+// PersistPolicy.cpp
+// Объединение уведомлений об изменении настроек в редкие проходы сохранения.
+#include "PersistPolicy.h"
+
+PersistCoalescer::PersistCoalescer(PersistSource& source, uint32_t quiet, uint32_t maxDelay)
+    : source(source), quiet(quiet), maxDelay(maxDelay), pending(false), firstDirty(0), lastDirty(0) {}
+
+uint32_t PersistCoalescer::remaining(uint32_t now) const {
+    if (!pending) return PERSIST_WAIT_FOREVER;
+    uint32_t sinceLast = now - lastDirty;
+    uint32_t sinceFirst = now - firstDirty;
+    if (sinceLast >= quiet || sinceFirst >= maxDelay) return 0;
+    uint32_t untilQuiet = quiet - sinceLast;
+    uint32_t untilMax = maxDelay - sinceFirst;
+    return untilQuiet < untilMax ? untilQuiet : untilMax;
+}
+
+uint32_t PersistCoalescer::next() {
+    while (1) {
+        // Без правок - сон до уведомления; с правками - до конца паузы или предельной задержки
+        uint32_t wait = remaining(source.now());
+        if (wait == 0) {
+            pending = false;
+            return PERSIST_EVENT_DIRTY;
+        }
+
+        uint32_t events = 0;
+        if (!source.wait(wait, events)) {
+            if (wait == PERSIST_WAIT_FOREVER) return 0;
+            continue;  // Таймаут: срок пересчитывается в начале цикла
+        }
+        if (events & PERSIST_EVENT_DIRTY) {
+            uint32_t now = source.now();
+            if (!pending) firstDirty = now;
+            lastDirty = now;
+            pending = true;
+        }
+        if (events & PERSIST_EVENT_URGENT) {
+            uint32_t reason = (events & PERSIST_EVENT_URGENT) | (pending ? PERSIST_EVENT_DIRTY : 0);
+            pending = false;
+            return reason;
+        }
+    }
+}
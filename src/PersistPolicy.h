@@ -0,0 +1,55 @@
+// PersistPolicy.h
+#ifndef PERSIST_POLICY_H
+#define PERSIST_POLICY_H
+
+#include <stdint.h>
+
+// Причины сохранения - биты уведомления задачи сохранения
+#define PERSIST_EVENT_DIRTY   0x01  // Настройки изменены (правка уставки); пишется после паузы в правках
+#define PERSIST_EVENT_MODE    0x02  // Смена режима: сохранить сразу
+#define PERSIST_EVENT_POWER   0x04  // Предупреждение о падении питания: сохранить сразу
+#define PERSIST_EVENT_URGENT  (PERSIST_EVENT_MODE | PERSIST_EVENT_POWER)
+
+// Ожидание без предела
+#define PERSIST_WAIT_FOREVER UINT32_MAX
+
+// Часы и уведомления для PersistCoalescer: на устройстве - тики и уведомления задачи FreeRTOS,
+// в тестах на хосте - сценарий в виртуальном времени.
+class PersistSource {
+public:
+    virtual ~PersistSource() = default;
+    // Текущее время в единицах, в которых заданы пределы PersistCoalescer (тики).
+    virtual uint32_t now() = 0;
+    // Ожидание уведомлений не дольше timeout (PERSIST_WAIT_FOREVER - без предела).
+    // true - пришли уведомления events; false - таймаут, а при PERSIST_WAIT_FOREVER - уведомлений больше не будет.
+    virtual bool wait(uint32_t timeout, uint32_t& events) = 0;
+};
+
+// Объединение уведомлений в проходы сохранения: правки (PERSIST_EVENT_DIRTY) пишутся после паузы quiet
+// без новых правок, но не позже maxDelay от первой несохранённой; PERSIST_EVENT_MODE и PERSIST_EVENT_POWER -
+// сразу. Время - беззнаковое с переполнением (разности по модулю 2^32).
+class PersistCoalescer {
+public:
+    PersistCoalescer(PersistSource& source, uint32_t quiet, uint32_t maxDelay);
+
+    // Ожидание следующего прохода сохранения. Возвращает его причину: биты PERSIST_EVENT_URGENT
+    // (вместе с PERSIST_EVENT_DIRTY, если были правки) или PERSIST_EVENT_DIRTY - пауза в правках выдержана;
+    // 0 - источник исчерпан (только в тестах).
+    uint32_t next();
+
+    // Есть несохранённые правки.
+    bool dirty() const { return pending; }
+
+private:
+    PersistSource& source;
+    uint32_t quiet;
+    uint32_t maxDelay;
+    bool pending;
+    uint32_t firstDirty;
+    uint32_t lastDirty;
+
+    // Сколько ещё ждать до сохранения правок (0 - пора); без правок - PERSIST_WAIT_FOREVER.
+    uint32_t remaining(uint32_t now) const;
+};
+
+#endif
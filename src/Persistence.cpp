@@ -0,0 +1,99 @@
+// Persistence.cpp
+// Фоновое сохранение настроек: объединение правок и запись во флеш вне задач ввода и управления.
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Persistence.h"
+#include "PersistPolicy.h"
+#include "EEPROMHandler.h"
+#include "ChannelState.h"
+#include "Config.h"
+
+static TaskHandle_t persistTask = NULL;
+static std::atomic<uint32_t> dirtyEvents{0};
+static std::atomic<uint32_t> commits{0};
+static std::atomic<uint32_t> writes{0};
+static std::atomic<uint32_t> immediate{0};
+
+// Флеш трогается в окне простоя задачи управления (см. waitNextPublish)
+static void waitControlIdle() {
+    waitNextPublish(pdMS_TO_TICKS(2 * CONTROL_PERIOD_MS));
+}
+
+// Время и уведомления задачи сохранения для PersistCoalescer
+class TaskNotifySource : public PersistSource {
+public:
+    uint32_t now() override { return xTaskGetTickCount(); }
+    bool wait(uint32_t timeout, uint32_t& events) override {
+        return xTaskNotifyWait(0, UINT32_MAX, &events, timeout == PERSIST_WAIT_FOREVER ? portMAX_DELAY : timeout) == pdTRUE;
+    }
+};
+
+// Проход сохранения по причине reason (см. PersistCoalescer::next)
+static void commit(uint32_t reason) {
+    // При падении питания каждая миллисекунда на счету: без ожидания окна простоя
+    bool power = reason & PERSIST_EVENT_POWER;
+    if (!power) waitControlIdle();
+    commits++;
+    if (reason & PERSIST_EVENT_URGENT) immediate++;
+    if (saveSettings()) writes++;
+    if (power) return;
+
+    // Следующий сектор журнала стирается заранее, отдельной операцией в своём окне простоя
+    waitControlIdle();
+    maintainSettings();
+}
+
+static void TaskPersistence(void *pvParameters) {
+    TaskNotifySource source;
+    PersistCoalescer coalescer(source, pdMS_TO_TICKS(PERSIST_QUIET_MS), pdMS_TO_TICKS(PERSIST_MAX_DELAY_MS));
+    while (1) {
+        uint32_t reason = coalescer.next();
+        if (reason) commit(reason);
+    }
+}
+
+#ifdef POWER_WARN_PIN
+// Выход супервизора питания: спад - питание уходит, настройки нужно сохранить немедленно
+static void IRAM_ATTR powerWarnISR() {
+    notifyPersistenceFromISR(PERSIST_EVENT_POWER);
+}
+#endif
+
+void beginPersistence() {
+    xTaskCreatePinnedToCore(TaskPersistence, "Persist", 3072, NULL, PERSIST_TASK_PRIORITY, &persistTask, UI_TASK_CORE);
+#ifdef POWER_WARN_PIN
+    pinMode(POWER_WARN_PIN, INPUT);
+    attachInterrupt(POWER_WARN_PIN, powerWarnISR, FALLING);
+#endif
+}
+
+void notifyPersistence(uint32_t events) {
+    if (!persistTask) return;
+    if (events & PERSIST_EVENT_DIRTY) dirtyEvents++;
+    xTaskNotify(persistTask, events, eSetBits);
+}
+
+void IRAM_ATTR notifyPersistenceFromISR(uint32_t events) {
+    if (!persistTask) return;
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(persistTask, events, eSetBits, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+PersistStats persistStats(bool reset) {
+    PersistStats s;
+    s.dirtyEvents = reset ? dirtyEvents.exchange(0) : dirtyEvents.load();
+    s.commits = reset ? commits.exchange(0) : commits.load();
+    s.writes = reset ? writes.exchange(0) : writes.load();
+    s.immediate = reset ? immediate.exchange(0) : immediate.load();
+    return s;
+}
+
+void reportPersistStats() {
+    PersistStats s = persistStats(true);
+    if (s.dirtyEvents == 0 && s.commits == 0) return;
+    Serial.printf("[SETTINGS] правок %u -> проходов сохранения %u (сразу %u), записей в журнал %u\n",
+                  s.dirtyEvents, s.commits, s.immediate, s.writes);
+}
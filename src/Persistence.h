@@ -0,0 +1,30 @@
+// Persistence.h
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include <Arduino.h>
+#include "PersistPolicy.h"  // PERSIST_EVENT_*
+
+// Счётчики задачи сохранения.
+struct PersistStats {
+    uint32_t dirtyEvents;   // Уведомлений об изменении
+    uint32_t commits;       // Проходов сохранения (после объединения уведомлений)
+    uint32_t writes;        // Из них действительно дописавших запись в журнал
+    uint32_t immediate;     // Проходов по смене режима или питанию, без ожидания паузы
+};
+
+// Задача сохранения настроек: собирает уведомления, пишет во флеш не чаще, чем после
+// PERSIST_QUIET_MS без правок (но не позже PERSIST_MAX_DELAY_MS от первой), либо сразу
+// по PERSIST_EVENT_MODE / PERSIST_EVENT_POWER (объединение - PersistCoalescer, проверяется в test/test_persist).
+// Флеш трогает только эта задача.
+void beginPersistence();
+// Уведомление задачи сохранения (PERSIST_EVENT_*); не блокирует, из задач.
+void notifyPersistence(uint32_t events);
+// То же из обработчика прерывания.
+void notifyPersistenceFromISR(uint32_t events);
+// Копия счётчиков; при reset обнуляет их.
+PersistStats persistStats(bool reset);
+// Счётчики в Serial (с обнулением), если за период что-то было.
+void reportPersistStats();
+
+#endif
@@ -0,0 +1,95 @@
+// SampleRing.h
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+
+// Биты состояния отсчёта
+#define SAMPLE_STATUS_OPEN_TC   0x01  // Термопара не подключена (бит D2 MAX6675)
+#define SAMPLE_STATUS_NO_DEVICE 0x02  // Модуль не отвечает (слово 0xFFFF)
+#define SAMPLE_STATUS_FAULT     (SAMPLE_STATUS_OPEN_TC | SAMPLE_STATUS_NO_DEVICE)
+
+// Сырой отсчёт датчика: код температуры в единицах 0.25 °C (как у MAX6675), биты состояния и тик защёлкивания.
+struct RawSample {
+    int16_t rawCounts;
+    uint8_t status;
+    TickType_t tick;
+};
+
+inline bool sampleValid(const RawSample& s) { return !(s.status & SAMPLE_STATUS_FAULT); }
+inline float sampleToCelsius(const RawSample& s) { return s.rawCounts * 0.25f; }
+
+// Позиция читателя в кольце. Каждый потребитель (PID, дисплей, журнал) держит свою.
+struct SampleCursor {
+    uint32_t next = 0;      // Индекс следующего непрочитанного отсчёта
+    uint32_t dropped = 0;   // Сколько отсчётов потеряно из-за отставания
+};
+
+// Кольцевой буфер отсчётов одного канала без блокировок.
+// Пишет только задача опроса датчиков; читателей может быть несколько, у каждого свой SampleCursor.
+// Писатель никогда не ждёт: отставший читатель теряет старые отсчёты и переходит к свежим.
+// Целостность прочитанной записи проверяется повторным чтением индекса записи после копирования.
+template <uint32_t N>
+class SampleRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Размер кольца должен быть степенью двойки");
+public:
+    // Добавление отсчёта (только из задачи-писателя).
+    void push(const RawSample& sample) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        // Запись в слот не должна стать видимой раньше прошлой публикации head: читатель,
+        // увидевший хоть часть новых данных, после своего acquire-барьера увидит и head >= h,
+        // и отбросит копию (как счётчик в SeqLock)
+        std::atomic_thread_fence(std::memory_order_release);
+        slots[h & (N - 1)] = sample;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Чтение следующего отсчёта для читателя cursor. false - новых отсчётов нет.
+    bool pop(SampleCursor& cursor, RawSample& out) const {
+        for (;;) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (cursor.next == h) return false;
+            if (h - cursor.next > N - 1) {
+                // Писатель обогнал читателя: пропускаем потерянные отсчёты
+                cursor.dropped += h - cursor.next - (N - 1);
+                cursor.next = h - (N - 1);
+            }
+            out = slots[cursor.next & (N - 1)];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (head.load(std::memory_order_relaxed) - cursor.next <= N - 1) {
+                cursor.next++;
+                return true;
+            }
+            // Запись была перезаписана во время копирования - повторяем
+        }
+    }
+
+    // Последний записанный отсчёт без продвижения курсоров. false - отсчётов ещё не было.
+    bool latest(RawSample& out) const {
+        for (;;) {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (h == 0) return false;
+            out = slots[(h - 1) & (N - 1)];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (head.load(std::memory_order_relaxed) - (h - 1) <= N - 1) return true;
+        }
+    }
+
+    // Курсор, начинающийся с текущего конца кольца (получит только будущие отсчёты).
+    SampleCursor tail() const {
+        SampleCursor c;
+        c.next = head.load(std::memory_order_acquire);
+        return c;
+    }
+
+private:
+    RawSample slots[N];
+    std::atomic<uint32_t> head{0};
+};
+
+typedef SampleRing<SAMPLE_RING_SIZE> ChannelSampleRing;
+
+#endif
@@ -0,0 +1,55 @@
+// SensorAcquisition.cpp
+// Пакетный опрос источников температуры по привязкам каналов.
+#include "SensorAcquisition.h"
+
+SensorAcquisition::SensorAcquisition(ChannelSampleRing* rings)
+    : rings(rings), scheduler(NUM_CHANNELS), sourceCount(0), boundMask(0)
+{
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        sources[i] = nullptr;
+        channelSource[i] = 0;
+        channelIndex[i] = 0;
+    }
+}
+
+void SensorAcquisition::bind(uint8_t channel, TemperatureSensor* sensor, uint8_t index) {
+    if (channel >= NUM_CHANNELS || !sensor || index >= sensor->size()) {
+        Serial.printf("[SENSOR] CH%d: Некорректная привязка датчика\n", channel + 1);
+        return;
+    }
+    uint8_t src = 0;
+    while (src < sourceCount && sources[src] != sensor) src++;
+    if (src == sourceCount) sources[sourceCount++] = sensor;
+
+    channelSource[channel] = src;
+    channelIndex[channel] = index;
+    boundMask |= 1UL << channel;
+    scheduler.setConversionMs(channel, sensor->conversionMs());
+}
+
+void SensorAcquisition::begin() {
+    for (uint8_t s = 0; s < sourceCount; s++) sources[s]->begin();
+}
+
+uint32_t SensorAcquisition::poll(TickType_t now) {
+    uint32_t due = scheduler.dueMask(now) & boundMask;
+    uint32_t fresh = 0;
+
+    for (uint8_t s = 0; s < sourceCount; s++) {
+        uint32_t request = 0;
+        for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+            if ((due & (1UL << ch)) && channelSource[ch] == s) request |= 1UL << channelIndex[ch];
+        }
+        // Источник вызывается и с пустой маской: асинхронные бэкенды забирают готовые результаты
+        uint32_t got = sources[s]->read(request);
+        if (!got) continue;
+        for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+            if ((boundMask & (1UL << ch)) && channelSource[ch] == s && (got & (1UL << channelIndex[ch]))) {
+                rings[ch].push(sources[s]->getSample(channelIndex[ch]));
+                fresh |= 1UL << ch;
+            }
+        }
+    }
+    scheduler.markRead(due, now);
+    return fresh;
+}
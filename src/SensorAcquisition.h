@@ -0,0 +1,38 @@
+// SensorAcquisition.h
+#ifndef SENSOR_ACQUISITION_H
+#define SENSOR_ACQUISITION_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "TemperatureSensor.h"
+#include "SensorScheduler.h"
+#include "SampleRing.h"
+
+// Сбор отсчётов со всех источников температуры в кольца каналов.
+// Каждый канал один раз привязывается к датчику (источник + номер в нём); за цикл
+// каждый источник читается одним пакетным вызовом только по тем датчикам, у которых
+// завершилось преобразование.
+class SensorAcquisition {
+public:
+    explicit SensorAcquisition(ChannelSampleRing* rings);
+
+    // Привязка канала к датчику index источника sensor. Вызывается в setup() до begin().
+    void bind(uint8_t channel, TemperatureSensor* sensor, uint8_t index);
+    // Инициализация всех привязанных источников.
+    void begin();
+    // Опрос готовых датчиков и запись отсчётов в кольца.
+    // Возвращает маску каналов (бит i - канал i), получивших новый отсчёт.
+    uint32_t poll(TickType_t now);
+
+private:
+    ChannelSampleRing* rings;
+    SensorScheduler scheduler;
+    TemperatureSensor* sources[NUM_CHANNELS];   // Различные источники
+    uint8_t sourceCount;
+    uint8_t channelSource[NUM_CHANNELS];        // Номер источника канала в sources
+    uint8_t channelIndex[NUM_CHANNELS];         // Номер датчика канала в источнике
+    uint32_t boundMask;                         // Каналы, у которых есть привязка
+};
+
+#endif
@@ -0,0 +1,37 @@
+// SensorScheduler.cpp
+// Учёт готовности преобразований датчиков температуры.
+#include "SensorScheduler.h"
+
+SensorScheduler::SensorScheduler(uint8_t count, uint32_t conversionMs)
+    : count(count > NUM_CHANNELS ? NUM_CHANNELS : count)
+{
+    for (uint8_t i = 0; i < this->count; i++) {
+        conversionTicks[i] = pdMS_TO_TICKS(conversionMs);
+        lastRead[i] = 0;
+        started[i] = false;
+    }
+}
+
+void SensorScheduler::setConversionMs(uint8_t index, uint32_t conversionMs) {
+    if (index < count) conversionTicks[index] = pdMS_TO_TICKS(conversionMs);
+}
+
+uint32_t SensorScheduler::dueMask(TickType_t now) const {
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        // Беззнаковая разность корректна и при переполнении счётчика тиков
+        if (!started[i] || (TickType_t)(now - lastRead[i]) >= conversionTicks[i]) {
+            mask |= 1UL << i;
+        }
+    }
+    return mask;
+}
+
+void SensorScheduler::markRead(uint32_t mask, TickType_t now) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (mask & (1UL << i)) {
+            lastRead[i] = now;
+            started[i] = true;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// SensorScheduler.h
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+
+// Планировщик опроса датчиков с учётом времени преобразования.
+// MAX6675 начинает новое преобразование при подъёме CS, а чтение до его окончания
+// прерывает преобразование. Планировщик помнит момент последнего чтения каждого датчика
+// и разрешает чтение только тех, у которых уже готово новое значение.
+class SensorScheduler {
+public:
+    SensorScheduler(uint8_t count, uint32_t conversionMs = MAX6675_CONVERSION_MS);
+
+    // Время преобразования отдельного датчика (по умолчанию - из конструктора).
+    void setConversionMs(uint8_t index, uint32_t conversionMs);
+    // Маска датчиков (бит i - датчик i), у которых к моменту now готово новое значение.
+    uint32_t dueMask(TickType_t now) const;
+    // Отметка о чтении датчиков из маски в момент now: с него отсчитывается следующее преобразование.
+    void markRead(uint32_t mask, TickType_t now);
+
+private:
+    uint8_t count;
+    TickType_t conversionTicks[NUM_CHANNELS];
+    TickType_t lastRead[NUM_CHANNELS];
+    bool started[NUM_CHANNELS];  // Было ли хотя бы одно чтение (после включения все датчики готовы)
+};
+
+#endif
@@ -0,0 +1,256 @@
+// SettingsJournal.cpp
+// Журнал настроек во флеш с CRC и распределением стираний по секторам.
+#include <string.h>
+#include "SettingsJournal.h"
+#include "Crc32.h"
+
+#define JOURNAL_MAGIC 0x4E524A53UL  // "SJRN"
+
+struct JournalSectorHeader {
+    uint32_t magic;
+    uint32_t generation;
+    uint32_t generationInv;
+};
+
+struct JournalRecordHeader {
+    uint16_t length;
+    uint16_t tag;
+    uint32_t crc;
+};
+
+static const uint32_t SECTOR_HEADER_SIZE = sizeof(JournalSectorHeader);
+static const uint32_t RECORD_HEADER_SIZE = sizeof(JournalRecordHeader);
+
+static uint32_t alignedSize(uint32_t len) {
+    return (len + 3) & ~3UL;
+}
+
+// CRC записи: длина и метка, затем данные
+static uint32_t recordCrc(uint16_t length, uint16_t tag, uint32_t dataCrcSeed = 0) {
+    uint16_t head[2] = {length, tag};
+    return crc32(head, sizeof(head), dataCrcSeed);
+}
+
+SettingsJournal::SettingsJournal(FlashRegion& flash)
+    : flash(flash), hasActive(false), activeSector(0), activeGeneration(0), writeOffset(0),
+      nextErased(false), lastSector(0), lastOffset(0), lastLength(NO_RECORD), lastTag(0),
+      appendCount(0), eraseCount(0) {}
+
+size_t SettingsJournal::maxPayload() const {
+    size_t room = flash.sectorSize() - SECTOR_HEADER_SIZE - RECORD_HEADER_SIZE;
+    return room < NO_RECORD ? room : NO_RECORD - 1;
+}
+
+bool SettingsJournal::readSectorHeader(uint32_t sector, uint32_t& generation) {
+    JournalSectorHeader h;
+    if (!flash.read(sector * flash.sectorSize(), &h, sizeof(h))) return false;
+    if (h.magic != JOURNAL_MAGIC || h.generation != ~h.generationInv) return false;
+    generation = h.generation;
+    return true;
+}
+
+bool SettingsJournal::checkRecord(uint32_t base, uint32_t offset, uint16_t& length, uint16_t& tag) {
+    JournalRecordHeader h;
+    if (!flash.read(base + offset, &h, sizeof(h))) return false;
+    if (h.length > maxPayload() || offset + RECORD_HEADER_SIZE + alignedSize(h.length) > flash.sectorSize()) return false;
+
+    // Данные читаются кусками: CRC без буфера под всю запись
+    uint32_t crc = recordCrc(h.length, h.tag);
+    uint8_t chunk[64];
+    uint32_t pos = base + offset + RECORD_HEADER_SIZE;
+    for (uint32_t left = h.length; left;) {
+        uint32_t n = left < sizeof(chunk) ? left : sizeof(chunk);
+        if (!flash.read(pos, chunk, n)) return false;
+        crc = crc32(chunk, n, crc);
+        pos += n;
+        left -= n;
+    }
+    if (crc != h.crc) return false;
+    length = h.length;
+    tag = h.tag;
+    return true;
+}
+
+uint32_t SettingsJournal::scanSector(uint32_t sector, bool& found, bool& clean) {
+    uint32_t base = sector * flash.sectorSize();
+    uint32_t offset = SECTOR_HEADER_SIZE;
+    found = false;
+    clean = true;
+    while (offset + RECORD_HEADER_SIZE <= flash.sectorSize()) {
+        JournalRecordHeader h;
+        if (!flash.read(base + offset, &h, sizeof(h))) {
+            clean = false;
+            break;
+        }
+        if (h.length == 0xFFFF && h.tag == 0xFFFF && h.crc == 0xFFFFFFFFUL) break;  // Конец записей
+
+        uint16_t length, tag;
+        if (!checkRecord(base, offset, length, tag)) {
+            clean = false;
+            break;
+        }
+        found = true;
+        lastSector = sector;
+        lastOffset = offset;
+        lastLength = length;
+        lastTag = tag;
+        offset += RECORD_HEADER_SIZE + alignedSize(length);
+    }
+    return offset;
+}
+
+bool SettingsJournal::isBlank(uint32_t from, uint32_t to) {
+    uint8_t chunk[64];
+    while (from < to) {
+        uint32_t n = to - from < sizeof(chunk) ? to - from : sizeof(chunk);
+        if (!flash.read(from, chunk, n)) return false;
+        for (uint32_t k = 0; k < n; k++) {
+            if (chunk[k] != 0xFF) return false;
+        }
+        from += n;
+    }
+    return true;
+}
+
+bool SettingsJournal::begin() {
+    const uint32_t count = flash.sectorCount();
+    if (count < 2) return false;
+
+    hasActive = false;
+    lastLength = NO_RECORD;
+    appendCount = 0;
+    eraseCount = 0;
+
+    // Новейшее поколение; сравнение через разность - переживает переполнение счётчика
+    for (uint32_t s = 0; s < count; s++) {
+        uint32_t generation;
+        if (!readSectorHeader(s, generation)) continue;
+        if (!hasActive || static_cast<int32_t>(generation - activeGeneration) > 0) {
+            hasActive = true;
+            activeSector = s;
+            activeGeneration = generation;
+        }
+    }
+    if (!hasActive) {
+        // Чистая (или чужая) область: первый append() откроет сектор 0
+        nextErased = isBlank(0, flash.sectorSize());
+        return true;
+    }
+
+    // Поколения идут по кругу: предыдущее лежит в предыдущем секторе
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t sector = (activeSector + count - k) % count;
+        uint32_t generation;
+        if (!readSectorHeader(sector, generation) || generation != activeGeneration - k) break;
+
+        bool found, clean;
+        uint32_t end = scanSector(sector, found, clean);
+        if (k == 0) {
+            // Дописывать можно только в чистый хвост: после оборванной записи сектор закрыт
+            uint32_t base = sector * flash.sectorSize();
+            bool tailBlank = clean && isBlank(base + end, base + flash.sectorSize());
+            writeOffset = tailBlank ? end : flash.sectorSize();
+        }
+        if (found) break;
+    }
+
+    uint32_t next = (activeSector + 1) % count;
+    nextErased = isBlank(next * flash.sectorSize(), (next + 1) * flash.sectorSize());
+    return true;
+}
+
+size_t SettingsJournal::load(void* data, size_t capacity, uint16_t* tag) {
+    if (!hasRecord()) return 0;
+    size_t n = lastLength < capacity ? lastLength : capacity;
+    if (!flash.read(lastSector * flash.sectorSize() + lastOffset + RECORD_HEADER_SIZE, data, n)) return 0;
+    if (tag) *tag = lastTag;
+    return lastLength;
+}
+
+bool SettingsJournal::erase(uint32_t sector) {
+    if (!flash.eraseSector(sector)) return false;
+    eraseCount++;
+    return true;
+}
+
+bool SettingsJournal::openSector(uint32_t sector, uint32_t generation) {
+    bool blank = hasActive ? (nextErased && sector == (activeSector + 1) % flash.sectorCount()) : nextErased;
+    if (!blank && !erase(sector)) return false;
+
+    JournalSectorHeader h = {JOURNAL_MAGIC, generation, ~generation};
+    if (!flash.write(sector * flash.sectorSize(), &h, sizeof(h))) return false;
+    uint32_t check;
+    if (!readSectorHeader(sector, check) || check != generation) return false;
+
+    hasActive = true;
+    activeSector = sector;
+    activeGeneration = generation;
+    writeOffset = SECTOR_HEADER_SIZE;
+    nextErased = false;
+    return true;
+}
+
+bool SettingsJournal::writeRecord(uint16_t tag, const void* data, size_t len) {
+    uint32_t base = activeSector * flash.sectorSize();
+    JournalRecordHeader h;
+    h.length = static_cast<uint16_t>(len);
+    h.tag = tag;
+    h.crc = crc32(data, len, recordCrc(h.length, tag));
+
+    // Сначала данные, потом заголовок: заголовок с корректной CRC появляется только у полной записи
+    uint32_t recordOffset = writeOffset;
+    uint16_t checkLength, checkTag;
+    bool ok = (!len || flash.write(base + recordOffset + RECORD_HEADER_SIZE, data, len)) &&
+              flash.write(base + recordOffset, &h, sizeof(h)) &&
+              checkRecord(base, recordOffset, checkLength, checkTag);
+    if (!ok) {
+        writeOffset = flash.sectorSize();  // Место испорчено - дальше только в новый сектор
+        return false;
+    }
+    writeOffset += RECORD_HEADER_SIZE + alignedSize(len);
+    lastSector = activeSector;
+    lastOffset = recordOffset;
+    lastLength = h.length;
+    lastTag = tag;
+    appendCount++;
+    return true;
+}
+
+bool SettingsJournal::append(uint16_t tag, const void* data, size_t len) {
+    if (len > maxPayload()) return false;
+    const uint32_t count = flash.sectorCount();
+    uint32_t need = RECORD_HEADER_SIZE + alignedSize(len);
+
+    // Две попытки: неудачная запись закрывает сектор, вторая идёт в новый
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!hasActive || writeOffset + need > flash.sectorSize()) {
+            uint32_t sector = hasActive ? (activeSector + 1) % count : 0;
+            uint32_t generation = hasActive ? activeGeneration + 1 : 1;
+            if (!openSector(sector, generation)) return false;
+        }
+        if (writeRecord(tag, data, len)) return true;
+    }
+    return false;
+}
+
+bool SettingsJournal::maintain() {
+    if (!hasActive || nextErased) return false;
+    uint32_t next = (activeSector + 1) % flash.sectorCount();
+    // Единственная корректная запись может лежать в следующем секторе (двухсекторная область
+    // после оборванной записи) - её не трогаем, пока не появится новая
+    if (hasRecord() && lastSector == next) return false;
+    if (!erase(next)) return false;
+    nextErased = true;
+    return true;
+}
+
+JournalStats SettingsJournal::stats() const {
+    JournalStats s;
+    s.sector = activeSector;
+    s.generation = activeGeneration;
+    s.used = hasActive ? writeOffset : 0;
+    s.capacity = flash.sectorSize();
+    s.appends = appendCount;
+    s.erases = eraseCount;
+    return s;
+}
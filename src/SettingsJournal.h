@@ -0,0 +1,79 @@
+// SettingsJournal.h
+#ifndef SETTINGS_JOURNAL_H
+#define SETTINGS_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FlashRegion.h"
+
+// Состояние журнала для диагностики износа.
+struct JournalStats {
+    uint32_t sector;        // Активный сектор
+    uint32_t generation;    // Поколение активного сектора (растёт при каждой смене сектора)
+    uint32_t used;          // Занято байт в активном секторе (с заголовком)
+    uint32_t capacity;      // Размер сектора
+    uint32_t appends;       // Записей с момента begin()
+    uint32_t erases;        // Стираний с момента begin()
+};
+
+// Журнал настроек во флеш: записи только дописываются в конец активного сектора,
+// каждая со своей CRC-32. Когда сектор заполнен, журнал переходит в следующий по кругу
+// (поколение + 1) и переносит туда только последнюю запись - это и есть уплотнение,
+// т.к. каждая запись - полный снимок настроек. Стирания распределяются по всем секторам области.
+//
+// Формат сектора: заголовок {magic, generation, ~generation}, затем записи
+// {length, tag, crc32(length, tag, данные)} + данные, выровненные на 4 байта.
+// Стёртая флеш (0xFF) в поле длины - конец записей. Данные пишутся раньше заголовка записи,
+// поэтому запись с корректной CRC всегда полная; оборванная запись закрывает сектор для дописывания.
+class SettingsJournal {
+public:
+    explicit SettingsJournal(FlashRegion& flash);
+
+    // Поиск последней корректной записи за один проход: заголовки секторов, затем записи
+    // от новейшего поколения к старым до первой найденной. false - область меньше двух секторов
+    // или флеш не читается; пустой журнал - не ошибка (hasRecord() == false).
+    bool begin();
+
+    bool hasRecord() const { return lastLength != NO_RECORD; }
+    // Данные последней записи: копирует не больше capacity байт, возвращает полную длину записи
+    // (0 - записей нет). tag, если не NULL, получает метку записи.
+    size_t load(void* data, size_t capacity, uint16_t* tag = NULL);
+    // Дописывание записи; при нехватке места - переход в следующий сектор.
+    // Запись читается обратно и проверяется по CRC.
+    bool append(uint16_t tag, const void* data, size_t len);
+    // Фоновое обслуживание: заранее стирает следующий сектор, чтобы append() при смене сектора
+    // не ждал стирания. true - что-то было сделано.
+    bool maintain();
+
+    // Наибольшая длина данных одной записи.
+    size_t maxPayload() const;
+    JournalStats stats() const;
+
+private:
+    static const uint16_t NO_RECORD = 0xFFFF;
+
+    FlashRegion& flash;
+    bool hasActive;         // Есть сектор с корректным заголовком
+    uint32_t activeSector;
+    uint32_t activeGeneration;
+    uint32_t writeOffset;   // Куда дописывать в активном секторе
+    bool nextErased;        // Следующий по кругу сектор уже стёрт
+    uint32_t lastSector;    // Где лежит последняя корректная запись
+    uint32_t lastOffset;
+    uint16_t lastLength;
+    uint16_t lastTag;
+    uint32_t appendCount;
+    uint32_t eraseCount;
+
+    bool readSectorHeader(uint32_t sector, uint32_t& generation);
+    // Проход по записям сектора; возвращает смещение конца последней разобранной записи,
+    // clean = false, если встретилась повреждённая запись.
+    uint32_t scanSector(uint32_t sector, bool& found, bool& clean);
+    bool checkRecord(uint32_t base, uint32_t offset, uint16_t& length, uint16_t& tag);
+    bool isBlank(uint32_t from, uint32_t to);
+    bool erase(uint32_t sector);
+    bool openSector(uint32_t sector, uint32_t generation);
+    bool writeRecord(uint16_t tag, const void* data, size_t len);
+};
+
+#endif
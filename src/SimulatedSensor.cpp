@@ -0,0 +1,43 @@
+// SimulatedSensor.cpp
+// Модель нагрева для работы контроллера без подключённых термопар.
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "SimulatedSensor.h"
+#include "Globals.h"
+
+SimulatedSensor::SimulatedSensor() : count(0) {}
+
+int SimulatedSensor::addDevice() {
+    if (count >= NUM_CHANNELS) return -1;
+    uint8_t i = count++;
+    temps[i] = SIM_AMBIENT_TEMP;
+    samples[i].rawCounts = static_cast<int16_t>(SIM_AMBIENT_TEMP * 4);
+    samples[i].status = 0;
+    samples[i].tick = 0;
+    return i;
+}
+
+void SimulatedSensor::begin() {
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < count; i++) samples[i].tick = now;
+}
+
+uint32_t SimulatedSensor::read(uint32_t mask) {
+    mask &= allMask();
+    TickType_t now = xTaskGetTickCount();
+    for (uint8_t i = 0; i < count; i++) {
+        if (!(mask & (1UL << i))) continue;
+        float dt = (TickType_t)(now - samples[i].tick) * portTICK_PERIOD_MS;
+        float power = channels[i] ? channels[i]->getDuty() / (float)PWM_MAX_DUTY : 0.0f;
+        float target = SIM_AMBIENT_TEMP + SIM_MAX_RISE * power;
+        float k = dt / SIM_TIME_CONSTANT_MS;
+        if (k > 1.0f) k = 1.0f;
+        temps[i] += (target - temps[i]) * k;
+
+        samples[i].rawCounts = static_cast<int16_t>(lroundf(temps[i] * 4));
+        samples[i].status = 0;
+        samples[i].tick = now;
+    }
+    return mask;
+}
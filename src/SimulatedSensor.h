@@ -0,0 +1,32 @@
+// SimulatedSensor.h
+#ifndef SIMULATED_SENSOR_H
+#define SIMULATED_SENSOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "Config.h"
+#include "TemperatureSensor.h"
+
+// Имитация термопар для отладки без железа: апериодическое звено первого порядка на канал.
+// Мощность берётся из скважности, поданной на канал с тем же индексом (channels[index]->getDuty()),
+// значение квантуется с шагом 0.25 °C, как у MAX6675.
+class SimulatedSensor : public TemperatureSensor {
+public:
+    SimulatedSensor();
+
+    // Добавление модельного датчика. Возвращает его индекс или -1, если мест нет.
+    int addDevice();
+
+    void begin() override;
+    uint32_t read(uint32_t mask) override;
+    uint8_t size() const override { return count; }
+    RawSample getSample(uint8_t index) const override { return samples[index]; }
+    uint32_t conversionMs() const override { return MAX6675_CONVERSION_MS; }
+
+private:
+    uint8_t count;
+    float temps[NUM_CHANNELS];
+    RawSample samples[NUM_CHANNELS];
+};
+
+#endif
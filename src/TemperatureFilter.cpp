@@ -0,0 +1,146 @@
+// TemperatureFilter.cpp
+// Цифровая фильтрация показаний термопар перед PID-регулятором.
+#include <Arduino.h>
+#include <math.h>
+#include "TemperatureFilter.h"
+
+void TemperatureFilter::configure(uint8_t stage, FilterType type, float param, float sampleRateHz) {
+    if (stage >= MAX_STAGES) return;
+    FilterStage& st = stages[stage];
+    st = FilterStage();
+    st.type = type;
+
+    switch (type) {
+        case FILTER_MEDIAN: {
+            int n = static_cast<int>(param);
+            if (n < 1) n = 1;
+            if (n > FILTER_MEDIAN_MAX) n = FILTER_MEDIAN_MAX;
+            st.size = static_cast<uint8_t>(n);
+            break;
+        }
+        case FILTER_EMA:
+            st.a = constrain(param, 0.0f, 1.0f);
+            break;
+        case FILTER_IIR1:
+        case FILTER_IIR2: {
+            // Частота среза ограничивается снизу нулём и сверху - чуть ниже частоты Найквиста
+            float fc = constrain(param, 0.0f, 0.45f * sampleRateHz);
+            float w0 = 2.0f * PI * fc / sampleRateHz;
+            if (type == FILTER_IIR1) {
+                st.a = 1.0f - expf(-w0);
+            } else {
+                // Биквад ФНЧ Баттерворта (Q = 1/sqrt(2)), нормирован на a0
+                float cosw = cosf(w0);
+                float alpha = sinf(w0) / (2.0f * 0.70710678f);
+                float a0 = 1.0f + alpha;
+                st.b0 = (1.0f - cosw) / 2.0f / a0;
+                st.b1 = (1.0f - cosw) / a0;
+                st.b2 = st.b0;
+                st.a1 = -2.0f * cosw / a0;
+                st.a2 = (1.0f - alpha) / a0;
+            }
+            break;
+        }
+        default:
+            st.type = FILTER_NONE;
+            break;
+    }
+    primed = false;
+}
+
+void TemperatureFilter::resetStage(FilterStage& st, float value) {
+    st.y = value;
+    st.count = 0;
+    st.pos = 0;
+    // Установившееся состояние биквада для входа value (коэффициент передачи на нуле равен 1)
+    st.z1 = (st.b1 + st.b2 - st.a1 - st.a2) * value;
+    st.z2 = (st.b2 - st.a2) * value;
+}
+
+void TemperatureFilter::reset(float value) {
+    for (uint8_t i = 0; i < MAX_STAGES; i++) resetStage(stages[i], value);
+    primed = true;
+}
+
+float TemperatureFilter::applyStage(FilterStage& st, float x) {
+    switch (st.type) {
+        case FILTER_MEDIAN: {
+            st.window[st.pos] = x;
+            st.pos = (st.pos + 1) % st.size;
+            if (st.count < st.size) st.count++;
+            // Сортировка вставками копии окна (не более FILTER_MEDIAN_MAX элементов)
+            float sorted[FILTER_MEDIAN_MAX];
+            for (uint8_t i = 0; i < st.count; i++) {
+                float v = st.window[i];
+                int j = i - 1;
+                while (j >= 0 && sorted[j] > v) {
+                    sorted[j + 1] = sorted[j];
+                    j--;
+                }
+                sorted[j + 1] = v;
+            }
+            st.y = (st.count & 1) ? sorted[st.count / 2]
+                                  : 0.5f * (sorted[st.count / 2 - 1] + sorted[st.count / 2]);
+            return st.y;
+        }
+        case FILTER_EMA:
+        case FILTER_IIR1:
+            st.y += st.a * (x - st.y);
+            return st.y;
+        case FILTER_IIR2: {
+            float y = st.b0 * x + st.z1;
+            st.z1 = st.b1 * x - st.a1 * y + st.z2;
+            st.z2 = st.b2 * x - st.a2 * y;
+            st.y = y;
+            return y;
+        }
+        default:
+            return x;
+    }
+}
+
+float TemperatureFilter::apply(float x) {
+    if (!primed) reset(x);
+    for (uint8_t i = 0; i < MAX_STAGES; i++) x = applyStage(stages[i], x);
+    return x;
+}
+
+#ifdef FILTER_BENCHMARK
+// Тестовый сигнал: постоянные 200 °C плюс равномерный шум ±1 °C, квантованный по 0.25 °C (как у MAX6675).
+static float benchSample(uint32_t& seed) {
+    seed = seed * 1664525UL + 1013904223UL;
+    float noise = ((seed >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+    return roundf((200.0f + noise) * 4.0f) / 4.0f;
+}
+
+void benchmarkFilters() {
+    const int samples = 2000;
+    const float fs = 1000.0f / (2 * CONTROL_PERIOD_MS);
+    struct { const char* name; FilterType type; float param; } cases[] = {
+        {"MEDIAN5", FILTER_MEDIAN, 5},
+        {"EMA0.2", FILTER_EMA, 0.2f},
+        {"IIR1", FILTER_IIR1, 0.2f},
+        {"IIR2", FILTER_IIR2, 0.2f},
+    };
+    for (auto& c : cases) {
+        TemperatureFilter filter;
+        filter.configure(0, c.type, c.param, fs);
+        uint32_t seed = 12345;
+        double inSq = 0, outSq = 0;
+        uint32_t cycles = 0;
+        for (int i = 0; i < samples; i++) {
+            float x = benchSample(seed);
+            uint32_t start = ESP.getCycleCount();
+            float y = filter.apply(x);
+            cycles += ESP.getCycleCount() - start;
+            if (i >= samples / 10) {  // Пропускаем переходный процесс
+                inSq += (x - 200.0f) * (x - 200.0f);
+                outSq += (y - 200.0f) * (y - 200.0f);
+            }
+        }
+        float attenuationDb = 10.0f * log10f(inSq / (outSq > 0 ? outSq : 1e-12));
+        Serial.printf("[BENCH] %s: %.1f тактов/отсчёт, подавление шума %.1f дБ\n",
+                      c.name, (float)cycles / samples, attenuationDb);
+    }
+}
+#endif
@@ -0,0 +1,60 @@
+// TemperatureFilter.h
+#ifndef TEMPERATURE_FILTER_H
+#define TEMPERATURE_FILTER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Типы звеньев фильтра
+enum FilterType {
+    FILTER_NONE,    // Без фильтрации
+    FILTER_MEDIAN,  // Медиана по окну из N отсчётов (подавление выбросов)
+    FILTER_EMA,     // Экспоненциальное скользящее среднее с коэффициентом alpha
+    FILTER_IIR1,    // БИХ 1-го порядка, задаётся частотой среза
+    FILTER_IIR2     // БИХ 2-го порядка (биквад Баттерворта), задаётся частотой среза
+};
+
+// Одно звено фильтра. Вся память статическая, время расчёта ограничено (медиана - не более
+// FILTER_MEDIAN_MAX * (FILTER_MEDIAN_MAX - 1) / 2 сравнений).
+struct FilterStage {
+    FilterType type = FILTER_NONE;
+    // Медиана
+    uint8_t size = 1;
+    uint8_t count = 0;
+    uint8_t pos = 0;
+    float window[FILTER_MEDIAN_MAX];
+    // EMA / IIR1: y += a * (x - y)
+    float a = 1.0f;
+    // IIR2: коэффициенты и состояние (прямая форма II, транспонированная)
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float z1 = 0.0f, z2 = 0.0f;
+    float y = 0.0f;
+};
+
+// Цепочка фильтрации температуры канала: медиана -> сглаживание.
+class TemperatureFilter {
+public:
+    static const uint8_t MAX_STAGES = 2;
+
+    // Настройка звена stage. param: размер окна (FILTER_MEDIAN), alpha (FILTER_EMA)
+    // или частота среза в Гц (FILTER_IIR1/FILTER_IIR2); sampleRateHz - частота отсчётов.
+    void configure(uint8_t stage, FilterType type, float param, float sampleRateHz);
+    // Сброс состояния всех звеньев на значение value (без переходного процесса от нуля).
+    void reset(float value);
+    // Обработка отсчёта. Первый отсчёт после настройки/сброса инициализирует состояние.
+    float apply(float x);
+
+private:
+    FilterStage stages[MAX_STAGES];
+    bool primed = false;
+
+    static float applyStage(FilterStage& st, float x);
+    static void resetStage(FilterStage& st, float value);
+};
+
+#ifdef FILTER_BENCHMARK
+// Замер тактов CPU на отсчёт и подавления шума для каждого типа фильтра с выводом в Serial.
+void benchmarkFilters();
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+// TemperatureSensor.h
+#ifndef TEMPERATURE_SENSOR_H
+#define TEMPERATURE_SENSOR_H
+
+#include <Arduino.h>
+#include "SampleRing.h"
+
+// Абстрактный источник температуры: один или несколько датчиков, читаемых пакетом.
+// Реализации: MAX6675Bus (программный пакет на общем CLK), MAX6675SpiBus (SPI/DMA),
+// SimulatedSensor (модель объекта без железа).
+class TemperatureSensor {
+public:
+    virtual ~TemperatureSensor() = default;
+
+    // Настройка железа. Вызывается один раз из setup().
+    virtual void begin() = 0;
+    // Число датчиков в источнике.
+    virtual uint8_t size() const = 0;
+    // Пакетное чтение датчиков из маски (бит i - датчик i).
+    // Возвращает маску датчиков, для которых getSample() отдаст новый отсчёт.
+    virtual uint32_t read(uint32_t mask) = 0;
+    // Последний отсчёт датчика index.
+    virtual RawSample getSample(uint8_t index) const = 0;
+    // Минимальный интервал между чтениями одного датчика (время преобразования), мс.
+    virtual uint32_t conversionMs() const = 0;
+
+    uint32_t allMask() const { return (1UL << size()) - 1; }
+};
+
+#endif
@@ -0,0 +1,70 @@
+// TextFormat.cpp
+// Форматирование строк интерфейса в фиксированные буферы (без String и snprintf).
+#include <Arduino.h>
+#include <math.h>
+#include "TextFormat.h"
+
+TextWriter::TextWriter(char* buffer, size_t capacity) : buf(buffer), cap(capacity), len(0) {
+    buf[0] = '\0';
+}
+
+TextWriter& TextWriter::str(const char* s) {
+    while (*s && len + 1 < cap) buf[len++] = *s++;
+    buf[len] = '\0';
+    return *this;
+}
+
+TextWriter& TextWriter::chr(char c, uint8_t count) {
+    while (count-- && len + 1 < cap) buf[len++] = c;
+    buf[len] = '\0';
+    return *this;
+}
+
+TextWriter& TextWriter::number(uint32_t magnitude, bool negative, uint8_t minDigits, uint8_t decimals,
+                               uint8_t width, char pad) {
+    // Цифры в обратном порядке; uint32_t - не более 10 цифр
+    char digits[12];
+    uint8_t n = 0;
+    do {
+        digits[n++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude || n < minDigits);
+
+    uint8_t total = n + (decimals ? 1 : 0) + (negative ? 1 : 0);
+    if (negative && pad == '0') chr('-');
+    if (width > total) chr(pad, width - total);
+    if (negative && pad != '0') chr('-');
+    while (n) {
+        if (decimals && n == decimals) chr('.');
+        chr(digits[--n]);
+    }
+    return *this;
+}
+
+TextWriter& TextWriter::u(uint32_t value, uint8_t width, char pad) {
+    return number(value, false, 1, 0, width, pad);
+}
+
+TextWriter& TextWriter::i(int32_t value, uint8_t width, char pad) {
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    return number(magnitude, value < 0, 1, 0, width, pad);
+}
+
+TextWriter& TextWriter::fixed(int32_t scaled, uint8_t decimals, uint8_t width, char pad) {
+    uint32_t magnitude = scaled < 0 ? 0u - static_cast<uint32_t>(scaled) : static_cast<uint32_t>(scaled);
+    // Не меньше одной цифры до точки: 5 при decimals = 1 -> "0.5"
+    return number(magnitude, scaled < 0, decimals + 1, decimals, width, pad);
+}
+
+TextWriter& TextWriter::fixed(float value, uint8_t decimals, uint8_t width, char pad) {
+    if (isnan(value)) return chr('-', width ? width : 1);
+    float scale = 1.0f;
+    for (uint8_t k = 0; k < decimals; k++) scale *= 10.0f;
+    return fixed(static_cast<int32_t>(lroundf(value * scale)), decimals, width, pad);
+}
+
+TextWriter& TextWriter::padTo(size_t column, char c) {
+    while (len < column && len + 1 < cap) buf[len++] = c;
+    buf[len] = '\0';
+    return *this;
+}
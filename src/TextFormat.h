@@ -0,0 +1,46 @@
+// TextFormat.h
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <Arduino.h>
+
+// Символ градуса в знакогенераторе HD44780 (ROM A00). UTF-8 "°" занимает два байта и на LCD не выводится.
+#define LCD_DEGREE '\xDF'
+
+// Длина строки на этапе компиляции (рекурсия - constexpr в стиле C++11).
+constexpr size_t constStrLen(const char* s) { return *s ? 1 + constStrLen(s + 1) : 0; }
+
+// Форматирование в заранее выделенный буфер без кучи и без printf.
+// Все методы возвращают *this для цепочек; вывод, не помещающийся в буфер, отбрасывается,
+// строка всегда завершается нулём. Ширина поля: число выравнивается вправо символом pad;
+// при pad = '0' знак минуса ставится перед нулями.
+class TextWriter {
+public:
+    // capacity - размер буфера вместе с завершающим нулём (не меньше 1).
+    TextWriter(char* buffer, size_t capacity);
+
+    TextWriter& str(const char* s);
+    TextWriter& chr(char c, uint8_t count = 1);
+    TextWriter& u(uint32_t value, uint8_t width = 0, char pad = ' ');
+    TextWriter& i(int32_t value, uint8_t width = 0, char pad = ' ');
+    // Число с фиксированной точкой: scaled = значение * 10^decimals (например, 1235 при decimals = 1 -> "123.5").
+    TextWriter& fixed(int32_t scaled, uint8_t decimals, uint8_t width = 0, char pad = ' ');
+    // То же для float с округлением до decimals знаков.
+    TextWriter& fixed(float value, uint8_t decimals, uint8_t width = 0, char pad = ' ');
+    // Дополнение символом c до позиции column (если строка уже длиннее - ничего).
+    TextWriter& padTo(size_t column, char c = ' ');
+
+    size_t length() const { return len; }
+    const char* c_str() const { return buf; }
+    void clear() { len = 0; buf[0] = '\0'; }
+
+private:
+    char* buf;
+    size_t cap;
+    size_t len;
+
+    // Вывод цифр магнитуды value со знаком и выравниванием по ширине.
+    TextWriter& number(uint32_t magnitude, bool negative, uint8_t minDigits, uint8_t decimals, uint8_t width, char pad);
+};
+
+#endif
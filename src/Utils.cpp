@@ -1,25 +1,91 @@
 // Utils.cpp
 // Реализация утилитарных функций для управления буззером (звуковая сигнализация).
+// Звуки воспроизводит отдельная задача-секвенсор; вызывающие только ставят запрос в очередь.
 #include <Arduino.h>
 #include <driver/ledc.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/queue.h>
 #include "Utils.h"
 
 static int buzzerVolume = 128; // Громкость по умолчанию (0–255)
 
+// Запрос на воспроизведение: либо мелодия по указателю, либо одна нота внутри запроса
+struct BuzzerRequest {
+    const BuzzerNote* notes;  // NULL - играть single
+    uint8_t count;
+    BuzzerNote single;
+};
+
+static QueueHandle_t buzzerQueue = NULL;
+static TaskHandle_t buzzerTask = NULL;
+
+// Стандартные сигналы
+static const BuzzerNote CONFIRM_PATTERN[] = {{1000, 100}};
+static const BuzzerNote ERROR_PATTERN[] = {{2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100}};
+static const BuzzerNote ALARM_PATTERN[] = {
+    {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100},
+    {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100}, {2000, 100}, {0, 100},
+};
+
+// Задача-секвенсор: единственный владелец канала буззера.
+// Уведомление задачи прерывает текущую мелодию (срочный запрос).
+static void TaskBuzzer(void *pvParameters) {
+    BuzzerRequest req;
+    while (1) {
+        if (xQueueReceive(buzzerQueue, &req, portMAX_DELAY) != pdTRUE) continue;
+        ulTaskNotifyTake(pdTRUE, 0);  // Старые уведомления относятся к уже снятым запросам
+        const BuzzerNote* notes = req.notes ? req.notes : &req.single;
+        uint8_t count = req.notes ? req.count : 1;
+        for (uint8_t i = 0; i < count; i++) {
+            if (notes[i].frequency) {
+                ledcWriteTone(BUZZER_CHANNEL, notes[i].frequency);
+                ledcWrite(BUZZER_CHANNEL, buzzerVolume);
+            } else {
+                ledcWriteTone(BUZZER_CHANNEL, 0);
+            }
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(notes[i].duration))) break;
+        }
+        ledcWriteTone(BUZZER_CHANNEL, 0);
+    }
+}
+
 // Инициализация буззера с использованием старого LEDC API: ledcSetup и ledcAttachPin.
 void setupBuzzer() {
     ledcSetup(BUZZER_CHANNEL, 1000, 8);
     ledcAttachPin(BUZZER_PIN, BUZZER_CHANNEL);
+    buzzerQueue = xQueueCreate(BUZZER_QUEUE_LENGTH, sizeof(BuzzerRequest));
+    xTaskCreatePinnedToCore(TaskBuzzer, "Buzzer", 2048, NULL, BUZZER_TASK_PRIORITY, &buzzerTask, UI_TASK_CORE);
+}
+
+static bool postBuzzer(const BuzzerRequest& req, bool urgent) {
+    if (!buzzerQueue) return false;
+    if (urgent) {
+        xQueueReset(buzzerQueue);
+        xTaskNotifyGive(buzzerTask);
+    }
+    // Без ожидания: если очередь полна, звук пропускается
+    return xQueueSend(buzzerQueue, &req, 0) == pdTRUE;
 }
 
 // Воспроизведение звука с заданной частотой и длительностью.
 void beep(int frequency, int duration) {
-    ledcWriteTone(BUZZER_CHANNEL, frequency);
-    ledcWrite(BUZZER_CHANNEL, buzzerVolume);
-    vTaskDelay(pdMS_TO_TICKS(duration));
-    ledcWriteTone(BUZZER_CHANNEL, 0);
+    BuzzerRequest req;
+    req.notes = NULL;
+    req.count = 1;
+    req.single.frequency = static_cast<uint16_t>(constrain(frequency, 0, 65535));
+    req.single.duration = static_cast<uint16_t>(constrain(duration, 0, 65535));
+    postBuzzer(req, false);
+}
+
+bool playMelody(const BuzzerNote* notes, uint8_t count, bool urgent) {
+    if (!notes || !count) return false;
+    BuzzerRequest req;
+    req.notes = notes;
+    req.count = count;
+    req.single.frequency = 0;
+    req.single.duration = 0;
+    return postBuzzer(req, urgent);
 }
 
 // Установка громкости буззера.
@@ -30,13 +96,15 @@ void setBuzzerVolume(int volume) {
 
 // Короткий звуковой сигнал подтверждения.
 void confirmBeep() {
-    beep(1000, 100);
+    playMelody(CONFIRM_PATTERN, sizeof(CONFIRM_PATTERN) / sizeof(CONFIRM_PATTERN[0]));
 }
 
 // Звуковая сигнализация ошибки (три коротких сигнала).
 void errorBeep() {
-    for (int i = 0; i < 3; i++) {
-        beep(2000, 100);
-        vTaskDelay(pdMS_TO_TICKS(100));
-    }
+    playMelody(ERROR_PATTERN, sizeof(ERROR_PATTERN) / sizeof(ERROR_PATTERN[0]));
+}
+
+// Аварийный сигнал (десять коротких сигналов), вне очереди.
+void alarmBeep() {
+    playMelody(ALARM_PATTERN, sizeof(ALARM_PATTERN) / sizeof(ALARM_PATTERN[0]), true);
 }
@@ -5,15 +5,27 @@
 #include <Arduino.h>
 #include "Config.h"
 
-// Инициализация буззера
+// Нота мелодии буззера: частота (Гц, 0 - пауза) и длительность (мс)
+struct BuzzerNote {
+    uint16_t frequency;
+    uint16_t duration;
+};
+
+// Инициализация буззера и задачи-секвенсора, которая владеет каналом LEDC.
+// Все функции ниже только ставят звук в очередь и сразу возвращаются.
 void setupBuzzer();
 // Воспроизведение звука с заданной частотой (Hz) и длительностью (ms)
 void beep(int frequency, int duration);
+// Воспроизведение мелодии из count нот. Массив notes должен жить до конца воспроизведения
+// (статический или глобальный). urgent - прервать текущий звук и очистить очередь.
+bool playMelody(const BuzzerNote* notes, uint8_t count, bool urgent = false);
 // Установка громкости буззера (0-255)
 void setBuzzerVolume(int volume);
 // Короткий звуковой сигнал подтверждения
 void confirmBeep();
 // Звуковая сигнализация ошибки (несколько коротких сигналов)
 void errorBeep();
+// Аварийный сигнал: прерывает всё остальное
+void alarmBeep();
 
 #endif
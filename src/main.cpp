@@ -4,26 +4,55 @@
 // Модифицированы функции задач для использования неблокирующих задержек (vTaskDelay).
   
 #include <Arduino.h>
-#include <GyverMAX6675.h>
 #include <EncButton.h>
 #include <LiquidCrystal_PCF8574.h>
-#include <EEPROM.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
 #include "Config.h"
 #include "HeaterChannel.h"
+#include "SensorAcquisition.h"
+#include "MAX6675Bus.h"
+#include "MAX6675SpiBus.h"
+#include "SimulatedSensor.h"
 #include "Globals.h"
 #include "Emergency.h"
 #include "Display.h"
 #include "Utils.h"
 #include "EEPROMHandler.h"
+#include "Persistence.h"
+#include "DataLogger.h"
+#include "History.h"
+#include "ControlTiming.h"
+#include "PIDBank.h"
+#include "ChannelTable.h"
+#include "ChannelState.h"
+#include "InputEvents.h"
+#include "TextFormat.h"
 #include <driver/ledc.h>
 
-// Глобальные объекты энкодеров
-EncButton enc1(ENC1_DT, ENC1_CLK, ENC1_SW);
-EncButton enc2(ENC2_DT, ENC2_CLK, ENC2_SW);
-EncButton enc3(ENC3_DT, ENC3_CLK, ENC3_SW);
+// Источник температуры: общий CLK, все каналы читаются одним пакетом (или очередью SPI/DMA, или модель).
+// Датчики регистрируются в setup() по строкам CHANNEL_TABLE.
+#if defined(TC_BACKEND_SIM)
+SimulatedSensor sensorBus;
+#elif defined(TC_BACKEND_SPI)
+MAX6675SpiBus sensorBus(TC_CLK_PIN, TC_SPI_MISO_PIN);
+#else
+MAX6675Bus sensorBus(TC_CLK_PIN);
+#endif
+SensorAcquisition acquisition(sampleRings);
+
+// Регистрация датчика канала в источнике температуры по строке таблицы.
+static int addSensor(const ChannelDescriptor& desc) {
+#if defined(TC_BACKEND_SIM)
+    (void)desc;
+    return sensorBus.addDevice();
+#elif defined(TC_BACKEND_SPI)
+    return sensorBus.addDevice(desc.tcCsPin);
+#else
+    return sensorBus.addDevice(desc.tcDataPin, desc.tcCsPin);
+#endif
+}
 
 // Переменные для управления режимами и настройки уставок
 unsigned long lastEncoderActionTime = 0;
@@ -39,194 +68,339 @@ void updateServiceMessage(const char* message) {
     }
 }
 
-// Задача автотюнинга (заглушка). Исправлено: мьютекс освобождается до задержки.
+// Задача автотюнинга (заглушка). Мьютекс освобождается до задержки и до updateServiceMessage(),
+// который берёт его сам (как в TaskInputEvents).
 void TaskAutotune(void *pvParameters) {
     while (1) {
         if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(50))) {
-            if (systemMode == AUTOTUNE_MODE) {
+            bool autotune = (systemMode == AUTOTUNE_MODE);
+            xSemaphoreGive(systemMutex);
+            if (autotune) {
                 updateServiceMessage("***AUTOTUNE MODE***");
-                xSemaphoreGive(systemMutex);  // /// MODIFIED: Выход из критической секции перед задержкой
                 vTaskDelay(pdMS_TO_TICKS(1000));  // Неблокирующая задержка
+                bool standby = false;
                 if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(50))) {
                     systemMode = STANDBY_MODE;
-                    updateServiceMessage("***standby mode***");
+                    standby = true;
                     xSemaphoreGive(systemMutex);
                 }
-            } else {
-                xSemaphoreGive(systemMutex);
+                if (standby) updateServiceMessage("***standby mode***");
             }
         }
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
-// Задача обновления энкодеров: обработка вращений, кликов, удержаний.
-void TaskUpdateEncoders(void *pvParameters) {
-    const TickType_t xFrequency = pdMS_TO_TICKS(20);
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+// Действия интерфейса, выполняемые после освобождения systemMutex
+// (updateServiceMessage() сам берёт мьютекс, сигналы буззера не должны держать блокировку).
+struct InputResult {
+    char message[32];
+    bool hasMessage;
+    bool confirm;
+    bool error;
+    bool dirty;     // Уставки изменены - уведомить задачу сохранения
+};
 
-    while (1) {
-        if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(30))) {
-            EncButton* encoders[] = {&enc1, &enc2, &enc3};
-            for (int i = 0; i < NUM_CHANNELS; i++) {
-                EncButton* enc = encoders[i];
-                enc->tick();
-                
-                // Обработка удержания
-                if (enc->hold()) {
-                    if (systemMode == STANDBY_MODE) {
-                        if (i == 1) {
-                            systemMode = SETTING_MODE;
-                            updateServiceMessage("***SETTING MODE***");
-                            confirmBeep();
-                        } else if (i == 2) {
-                            systemMode = CALIBRATION_MODE;
-                            updateServiceMessage("***CALIBRATION MODE***");
-                            confirmBeep();
-                        } else if (i == 0 && enc3.hold()) { // Комбинация для автотюнинга
-                            systemMode = AUTOTUNE_MODE;
-                            updateServiceMessage("***AUTOTUNE MODE***");
-                            confirmBeep();
-                        }
-                    } else if (systemMode == WORKING_MODE) {
-                        systemMode = STANDBY_MODE;
-                        updateServiceMessage("***standby mode***");
-                        confirmBeep();
-                    }
-                }
+static void setResultMessage(InputResult& res, const char* message) {
+    strncpy(res.message, message, sizeof(res.message) - 1);
+    res.message[sizeof(res.message) - 1] = '\0';
+    res.hasMessage = true;
+}
 
-                // Обработка клика
-                if (enc->click()) {
-                    if (systemMode == STANDBY_MODE) {
-                        systemMode = WORKING_MODE;
-                        updateServiceMessage("***working mode***");
-                        confirmBeep();
-                    } else if (systemMode == WORKING_MODE) {
-                        if (!settingModeActive) {
-                            settingModeActive = true;
-                            activeChannel = i;
-                            String msg = "***SET TEMP SP" + String(i + 1) + "***";
-                            updateServiceMessage(msg.c_str());
-                            lastEncoderActionTime = millis();
-                            confirmBeep();
-                        } else if (activeChannel == i) {
-                            channels[i]->setSetpoint(channels[i]->getSetpoint());
-                            settingModeActive = false;
-                            activeChannel = -1;
-                            updateServiceMessage("***working mode***");
-                            confirmBeep();
-                        }
-                    }
+// Логика режимов для одного события ввода. Вызывается под systemMutex.
+static void handleInputEvent(const InputEvent& ev, InputResult& res) {
+    int i = ev.channel;
+    switch (ev.type) {
+        case INPUT_HOLD:
+            if (systemMode == STANDBY_MODE) {
+                if (i == 1) {
+                    systemMode = SETTING_MODE;
+                    setResultMessage(res, "***SETTING MODE***");
+                    res.confirm = true;
+                } else if (i == 2) {
+                    systemMode = CALIBRATION_MODE;
+                    setResultMessage(res, "***CALIBRATION MODE***");
+                    res.confirm = true;
                 }
+            } else if (systemMode == WORKING_MODE) {
+                systemMode = STANDBY_MODE;
+                setResultMessage(res, "***standby mode***");
+                res.confirm = true;
+            }
+            break;
 
-                // Обработка вращения энкодера
-                if (enc->turn()) {
-                    if (systemMode == STANDBY_MODE || (systemMode == WORKING_MODE && settingModeActive && activeChannel == i)) {
-                        double delta = enc->dir() * 0.5;
-                        double newSetpoint = channels[i]->getSetpoint() + delta;
-                        channels[i]->setSetpoint(newSetpoint);
-                        lastEncoderActionTime = millis();
-                        confirmBeep();
-                    }
-                }
+        case INPUT_COMBO_HOLD:  // Комбинация для автотюнинга
+            if (systemMode == STANDBY_MODE) {
+                systemMode = AUTOTUNE_MODE;
+                setResultMessage(res, "***AUTOTUNE MODE***");
+                res.confirm = true;
+            } else if (systemMode == WORKING_MODE) {
+                systemMode = STANDBY_MODE;
+                setResultMessage(res, "***standby mode***");
+                res.confirm = true;
             }
-            // Обработка таймаутов ввода
-            if (systemMode == STANDBY_MODE && (millis() - lastEncoderActionTime > 2000)) {
-                for (int i = 0; i < NUM_CHANNELS; i++) {
+            break;
+
+        case INPUT_CLICK:
+            if (systemMode == STANDBY_MODE) {
+                // Запуск после аварии - явное действие оператора: выходы снова подключаются к ШИМ
+                if (heatersTripped()) rearmHeaters();
+                systemActive = true;
+                systemMode = WORKING_MODE;
+                setResultMessage(res, "***working mode***");
+                res.confirm = true;
+            } else if (systemMode == WORKING_MODE) {
+                if (!settingModeActive) {
+                    settingModeActive = true;
+                    activeChannel = i;
+                    TextWriter(res.message, sizeof(res.message)).str("***SET TEMP SP").u(i + 1).str("***");
+                    res.hasMessage = true;
+                    lastEncoderActionTime = ev.timeMs;
+                    res.confirm = true;
+                } else if (activeChannel == i) {
                     channels[i]->setSetpoint(channels[i]->getSetpoint());
+                    settingModeActive = false;
+                    activeChannel = -1;
+                    setResultMessage(res, "***working mode***");
+                    res.confirm = true;
                 }
-            } else if (settingModeActive && (millis() - lastEncoderActionTime > 5000)) {
+            }
+            break;
+
+        case INPUT_TURN:
+            if (systemMode == STANDBY_MODE || (systemMode == WORKING_MODE && settingModeActive && activeChannel == i)) {
+                float delta = ev.steps * 0.5f;
+                channels[i]->setSetpoint(channels[i]->getSetpoint() + delta);
+                lastEncoderActionTime = ev.timeMs;
+                res.confirm = true;
+                res.dirty = true;
+            }
+            break;
+    }
+}
+
+// Задача режимов: спит на очереди событий ввода и берёт systemMutex только на время их обработки.
+// Без событий просыпается лишь к таймауту режима настройки уставки.
+void TaskInputEvents(void *pvParameters) {
+    while (1) {
+        TickType_t wait = portMAX_DELAY;
+        if (settingModeActive) {
+            uint32_t elapsed = millis() - lastEncoderActionTime;
+            wait = elapsed >= SETPOINT_EDIT_TIMEOUT_MS ? 0 : pdMS_TO_TICKS(SETPOINT_EDIT_TIMEOUT_MS - elapsed);
+        }
+
+        InputEvent ev;
+        bool received = xQueueReceive(inputQueue, &ev, wait) == pdTRUE;
+        InputResult res = {};
+        bool modeChanged = false;
+        if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(30))) {
+            SystemMode modeBefore = systemMode;
+            bool editingBefore = settingModeActive;
+            if (received) {
+                // Обрабатываем все накопившиеся события за один захват мьютекса
+                do {
+                    handleInputEvent(ev, res);
+                } while (xQueueReceive(inputQueue, &ev, 0) == pdTRUE);
+            }
+            // Обработка таймаута ввода уставки
+            if (settingModeActive && (millis() - lastEncoderActionTime >= SETPOINT_EDIT_TIMEOUT_MS)) {
                 settingModeActive = false;
                 if (activeChannel >= 0) {
                     channels[activeChannel]->setSetpoint(channels[activeChannel]->getSetpoint());
                 }
                 activeChannel = -1;
-                updateServiceMessage("***working mode***");
-                errorBeep();
+                setResultMessage(res, "***working mode***");
+                res.error = true;
             }
+            modeChanged = systemMode != modeBefore || settingModeActive != editingBefore;
             xSemaphoreGive(systemMutex);
         }
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+
+        if (res.hasMessage) notifyDisplay(DISPLAY_EVENT_INPUT);  // Смена режима или начало/конец настройки уставки
+        if (res.hasMessage) updateServiceMessage(res.message);
+        if (res.error) errorBeep();
+        else if (res.confirm) confirmBeep();
+        // Правки копятся в задаче сохранения; смена режима или конец правки уставки - запись сразу
+        if (res.dirty || modeChanged) {
+            notifyPersistence((res.dirty ? PERSIST_EVENT_DIRTY : 0) | (modeChanged ? PERSIST_EVENT_MODE : 0));
+        }
     }
 }
 
+// Каналы, температура которых в полосе ±0.5 °C от уставки (по последнему расчёту PID)
+static uint32_t reachedMask = 0;
+
+// Звуковой сигнал о достижении уставки: один раз при входе температуры канала в полосу ±0.5 °C.
+static void signalSetpointReached(uint32_t updated) {
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        uint32_t bit = 1UL << i;
+        if (!(updated & bit)) continue;
+        bool reached = fabsf(pidBank.getInputValue(i) - pidBank.getSetpointValue(i)) < 0.5f;
+        if (reached && !(reachedMask & bit)) {
+            confirmBeep();
+            reachedMask |= bit;
+        } else if (!reached) {
+            reachedMask &= ~bit;
+        }
+    }
+}
+
+// Публикация снимка состояния каналов на конец цикла управления.
+// Вызывается под systemMutex, поэтому уставки и режим согласованы с тем, что видел цикл.
+// Задача дисплея будится, только если изменилось что-то видимое на экране.
+static void publishState(uint32_t cycle) {
+    SystemSnapshot snap;
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        ChannelState& st = snap.channels[i];
+        if (!channels[i]) {
+            st.temperature = NAN;
+            st.setpoint = 0.0f;
+            st.output = 0;
+            st.flags = CHANNEL_FLAG_SENSOR_FAULT;
+            continue;
+        }
+        st.temperature = channels[i]->getTemperature();
+        st.setpoint = channels[i]->getSetpoint();
+        st.output = static_cast<int16_t>(channels[i]->getDuty());
+        st.flags = (isnan(st.temperature) ? CHANNEL_FLAG_SENSOR_FAULT : 0) |
+                   (st.output > 0 ? CHANNEL_FLAG_HEATING : 0) |
+                   ((reachedMask & (1UL << i)) ? CHANNEL_FLAG_REACHED : 0);
+    }
+    snap.mode = systemMode;
+    snap.cycle = cycle;
+    snap.tick = xTaskGetTickCount();
+    systemState.write(snap);
+    notifyDisplayState(snap);
+    historyAdd(snap);
+    logSnapshot(snap);
+}
+
 // Задача управления нагревателями: считывает температуру, обновляет PID и управляет выходом.
+// Датчики опрашиваются только после завершения преобразования, PID считается только по новым отсчётам,
+// причём для всех каналов сразу - одним проходом pidBank.update().
+// Работает на ядре CONTROL_TASK_CORE; джиттер и время каждого цикла учитываются в controlTiming.
+// В конце цикла публикует снимок состояния (systemState) для остальных задач и кормит controlWatchdog.
 void TaskControlHeaters(void *pvParameters) {
-    const TickType_t xFrequency = pdMS_TO_TICKS(100);
+    const TickType_t xFrequency = pdMS_TO_TICKS(CONTROL_PERIOD_MS);
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32_t cycle = 0;
 
     while (1) {
+        controlTiming.cycleStart();
+        controlWatchdog.setPhase(CONTROL_PHASE_WAIT_MUTEX);
         if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(50))) {
+            // Пакетный опрос готовых датчиков, отсчёты попадают в кольца каналов
+            controlWatchdog.setPhase(CONTROL_PHASE_ACQUIRE);
+            uint32_t fresh = acquisition.poll(xTaskGetTickCount());
             for (int i = 0; i < NUM_CHANNELS; i++) {
-                if (channels[i]) {
+                if (channels[i] && (fresh & (1UL << i))) {
                     channels[i]->readAndUpdateTemperature();
-                    if (systemMode == WORKING_MODE) {
-                        channels[i]->updatePID();
-                        channels[i]->controlHeater(channels[i]->getOutput());
-                    } else {
-                        channels[i]->controlHeater(0);
+                }
+            }
+            controlWatchdog.setPhase(CONTROL_PHASE_PID);
+            if (systemMode == WORKING_MODE) {
+                uint32_t updated = pidBank.update(fresh);
+                for (int i = 0; i < NUM_CHANNELS; i++) {
+                    if (channels[i] && (updated & (1UL << i))) {
+                        channels[i]->controlHeater(pidBank.getOutput(i));
                     }
                 }
+                signalSetpointReached(updated);
+            } else {
+                for (int i = 0; i < NUM_CHANNELS; i++) {
+                    if (channels[i]) channels[i]->controlHeater(0);
+                }
             }
+            controlWatchdog.setPhase(CONTROL_PHASE_PUBLISH);
+            publishState(++cycle);
             xSemaphoreGive(systemMutex);
+            // Надзор кормится только полным циклом: без мьютекса выходы не обновлялись
+            controlWatchdog.feed();
         }
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-    }
-}
-
-// Задача обновления дисплея: обновляет данные по каналам и сервисное сообщение.
-void TaskUpdateDisplay(void *pvParameters) {
-    const TickType_t xFrequency = pdMS_TO_TICKS(250);
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-
-    while (1) {
-        if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50))) {
-            updateDisplay();
-            xSemaphoreGive(displayMutex);
-        } else {
-            Serial.println("[DISPLAY] Не удалось захватить мьютекс для обновления!");
-        }
+        controlWatchdog.setPhase(CONTROL_PHASE_IDLE);
+        controlTiming.cycleEnd();
         vTaskDelayUntil(&xLastWakeTime, xFrequency);
     }
 }
 
 void setup() {
     Serial.begin(115200);
-    initEEPROM();
+    initSettingsStore();
     setupBuzzer();
-    initDisplay();
 
-    // Создаем мьютексы
+    // Создаем мьютексы (до инициализации дисплея: initDisplay() берёт displayMutex)
     systemMutex = xSemaphoreCreateMutex();
     displayMutex = xSemaphoreCreateMutex();
 
-    // Создаем датчики для системы (одновременно используются всеми каналами)
-    GyverMAX6675<18, 17, 4>* sensor1 = new GyverMAX6675<18, 17, 4>();
-    GyverMAX6675<18, 5, 16>* sensor2 = new GyverMAX6675<18, 5, 16>();
-    GyverMAX6675<18, 19, 23>* sensor3 = new GyverMAX6675<18, 19, 23>();
+    initDisplay();
+#ifdef LCD_BENCHMARK
+    benchmarkDisplay(20);
+#endif
+
+    // Энкодеры: прерывания GPIO и задача распознавания событий ввода. До датчиков, чтобы все пины
+    // ввода были настроены прежде, чем шина датчиков начнёт опрос (события копятся в очереди до задачи Input)
+    beginInput();
+
+    // Датчики каналов по таблице и привязка к источнику температуры
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        int sensorIndex = addSensor(CHANNEL_TABLE[i]);
+        if (sensorIndex < 0) {
+            Serial.printf("[SETUP] CH%d: Нет места под датчик\n", i + 1);
+            continue;
+        }
+        acquisition.bind(i, &sensorBus, sensorIndex);
+    }
+    acquisition.begin();
+#if defined(MAX6675_BENCHMARK) && !defined(TC_BACKEND_SPI) && !defined(TC_BACKEND_SIM)
+    benchmarkSensorBus(sensorBus, 1000);
+#endif
+#ifdef FILTER_BENCHMARK
+    benchmarkFilters();
+#endif
+#ifdef PID_BENCHMARK
+    benchmarkPID();
+#endif
 
     // Инициализация каналов нагревателей
-    channels[0] = new HeaterChannel(sensor1, sensor2, sensor3, &enc1, HEATER1_PIN, 0, LEDC_TIMER_0, 0, DEFAULT_SETPOINT);
-    channels[1] = new HeaterChannel(sensor1, sensor2, sensor3, &enc2, HEATER2_PIN, 1, LEDC_TIMER_1, 1, DEFAULT_SETPOINT);
-    channels[2] = new HeaterChannel(sensor1, sensor2, sensor3, &enc3, HEATER3_PIN, 2, LEDC_TIMER_2, 2, DEFAULT_SETPOINT);
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        channels[i] = new HeaterChannel(CHANNEL_TABLE[i], &sampleRings[i], &encoders[i], i);
+    }
 
-    // Загрузка настроек (уставок и калибровочных смещений) из EEPROM
+    // Загрузка настроек (уставок и калибровочных смещений) из журнала во флеш
     loadSettings();
+    // Задача сохранения: дальше во флеш пишет только она
+    beginPersistence();
+    // Журнал температур: кадры от задачи управления в кольцо во флеш
+    beginDataLogger();
+    Serial.printf("[HIST] История температур в RAM: %u байт\n", historyMemoryBytes());
+
+    // Быстрый путь аварийного отключения и задача аварии
+    beginEmergency();
+#ifdef SHUTDOWN_SELFTEST
+    shutdownSelfTest();
+#endif
 
-    // Создание задач FreeRTOS
-    xTaskCreate(TaskUpdateEncoders, "Encoders", 2048, NULL, 2, NULL);
-    xTaskCreate(TaskControlHeaters, "Heaters", 2048, NULL, 1, NULL);
-    xTaskCreate(TaskUpdateDisplay, "Display", 2048, NULL, 1, NULL);
-    xTaskCreate(TaskAutotune, "Autotune", 2048, NULL, 1, NULL);
+    // Создание задач FreeRTOS: управление нагревателями - на своём ядре, интерфейс - на другом
+    TaskHandle_t controlTask = NULL;
+    xTaskCreatePinnedToCore(TaskControlHeaters, "Heaters", 4096, NULL, CONTROL_TASK_PRIORITY, &controlTask, CONTROL_TASK_CORE);
+    controlWatchdog.begin(controlTask);
+    xTaskCreatePinnedToCore(TaskInputEvents, "Input", 3072, NULL, 2, NULL, UI_TASK_CORE);
+    beginDisplayTask();
+    xTaskCreatePinnedToCore(TaskAutotune, "Autotune", 2048, NULL, 1, NULL, UI_TASK_CORE);
 
     if (xSemaphoreTake(systemMutex, pdMS_TO_TICKS(50))) {
         systemMode = STANDBY_MODE;
-        updateServiceMessage("***standby mode***");
         xSemaphoreGive(systemMutex);
     }
+    updateServiceMessage("***standby mode***");
 }
 
 void loop() {
-    // Основной цикл пуст, так как управление осуществляется через FreeRTOS задачи.
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    // Управление осуществляется через FreeRTOS задачи; здесь только периодические отчёты модулей.
+    vTaskDelay(pdMS_TO_TICKS(CONTROL_STATS_PERIOD_MS));
+    reportControlTiming();
+    reportDisplayStats();
+    reportPersistStats();
+    reportDataLogStats();
+    reportHistory();
 }
@@ -0,0 +1,24 @@
+// Arduino.h
+// Минимальная замена Arduino.h для тестов на хосте (окружение native): только то, что нужно
+// модулям, собираемым в тестах (FixedPID, TemperatureFilter, GyverPID и т.п.).
+#ifndef TEST_SUPPORT_ARDUINO_H
+#define TEST_SUPPORT_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define IRAM_ATTR
+
+// Время на хосте не идёт само: тесты, которым оно нужно, передают его явно
+inline uint32_t millis() { return 0; }
+
+#endif
@@ -0,0 +1,20 @@
+// driver/ledc.h
+// Замена драйвера LEDC ESP-IDF для тестов на хосте: только типы, нужные ChannelTable.h.
+#ifndef TEST_SUPPORT_DRIVER_LEDC_H
+#define TEST_SUPPORT_DRIVER_LEDC_H
+
+#include <soc/soc_caps.h>
+
+typedef enum {
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+    LEDC_HIGH_SPEED_MODE,
+#endif
+    LEDC_LOW_SPEED_MODE,
+} ledc_mode_t;
+
+typedef enum {
+    LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7,
+} ledc_channel_t;
+
+#endif
@@ -0,0 +1,13 @@
+// FreeRTOS.h
+// Подмена freertos/FreeRTOS.h для тестов на хосте: только типы и макросы тиков.
+#ifndef FREERTOS_SHIM_H
+#define FREERTOS_SHIM_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+#endif
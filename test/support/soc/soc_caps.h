@@ -0,0 +1,10 @@
+// soc/soc_caps.h
+// Возможности LEDC как у ESP32 (esp32dev) - таблица каналов проверяется в тестах с теми же пределами.
+#ifndef TEST_SUPPORT_SOC_CAPS_H
+#define TEST_SUPPORT_SOC_CAPS_H
+
+#define SOC_LEDC_SUPPORT_HS_MODE 1
+#define SOC_LEDC_CHANNEL_NUM 8
+#define SOC_LEDC_TIMER_NUM 4
+
+#endif
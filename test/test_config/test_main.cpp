@@ -0,0 +1,226 @@
+// test_main.cpp
+// Разбор и миграция записи конфигурации (configDecode): текущая раскладка, другой шаг канала,
+// другое число каналов, запись более новой прошивки, значения вне пределов и запись до схемы (V0).
+// Запуск: pio test -e native -f test_config
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "ConfigSchema.h"
+
+static const size_t FIELDS = sizeof(ChannelConfig) / 4;
+
+void setUp() {}
+void tearDown() {}
+
+// Настройки канала, отличные от значений по умолчанию и внутри пределов
+static ChannelConfig sampleChannel(uint8_t ch) {
+    ChannelConfig cfg;
+    cfg.setpoint = 150.0f + 10.0f * ch;
+    cfg.calibrationOffset = 1.5f + ch;
+    cfg.kp = 20.0f + ch;
+    cfg.ki = 0.5f;
+    cfg.kd = 2.0f + ch;
+    cfg.minSetpoint = 10.0f;
+    cfg.maxSetpoint = 400.0f;
+    cfg.maxOutput = 200.0f;
+    cfg.pidFlags = CONFIG_PID_ON_RATE;
+    return cfg;
+}
+
+// Запись с заголовком {version, count, stride}: каналы - sampleChannel(), у шага длиннее текущего
+// хвост канала - поля более новой прошивки (мусор для текущей). Возвращает длину записи.
+static size_t buildRecord(ConfigLoadBuffer& buf, uint16_t version, uint8_t count, uint8_t stride) {
+    memset(buf.raw, 0xAB, sizeof(buf.raw));
+    ConfigHeader h = {version, count, stride};
+    memcpy(buf.raw, &h, sizeof(h));
+    for (uint8_t ch = 0; ch < count; ch++) {
+        ChannelConfig cfg = sampleChannel(ch);
+        size_t n = stride < sizeof(cfg) ? stride : sizeof(cfg);
+        memcpy(buf.raw + sizeof(ConfigHeader) + ch * stride, &cfg, n);
+    }
+    return sizeof(ConfigHeader) + count * stride;
+}
+
+// Ожидаемый канал: первые kept полей из записи, остальные - по умолчанию
+static ChannelConfig expectedChannel(uint8_t ch, size_t kept) {
+    ConfigBlob defaults;
+    configDefaults(defaults);
+    ChannelConfig cfg = defaults.channels[ch];
+    ChannelConfig sample = sampleChannel(ch);
+    memcpy(&cfg, &sample, kept * 4);
+    return cfg;
+}
+
+static void assertChannel(const ChannelConfig& expected, const ChannelConfig& actual) {
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.setpoint, actual.setpoint, "setpoint");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.calibrationOffset, actual.calibrationOffset, "calibrationOffset");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.kp, actual.kp, "kp");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.ki, actual.ki, "ki");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.kd, actual.kd, "kd");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.minSetpoint, actual.minSetpoint, "minSetpoint");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.maxSetpoint, actual.maxSetpoint, "maxSetpoint");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected.maxOutput, actual.maxOutput, "maxOutput");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.pidFlags, actual.pidFlags, "pidFlags");
+}
+
+// После разбора заголовок всегда описывает текущую раскладку
+static void assertCurrentHeader(const ConfigBlob& blob) {
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_VERSION, blob.header.version);
+    TEST_ASSERT_EQUAL_UINT8(NUM_CHANNELS, blob.header.channelCount);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(ChannelConfig), blob.header.channelStride);
+}
+
+void test_current_layout_round_trip() {
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS, sizeof(ChannelConfig));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(ConfigBlob), length);
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_VERSION, report.fromVersion);
+    TEST_ASSERT_FALSE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(0, report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(sampleChannel(ch), buf.blob.channels[ch]);
+}
+
+void test_shorter_stride_defaults_missing_fields() {
+    // Прошивка, у которой в ChannelConfig было 5 полей (до minSetpoint)
+    const size_t kept = 5;
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS, kept * 4);
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(NUM_CHANNELS * (FIELDS - kept), report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(expectedChannel(ch, kept), buf.blob.channels[ch]);
+}
+
+void test_longer_stride_drops_unknown_fields() {
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS, sizeof(ChannelConfig) + 8);
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(0, report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(sampleChannel(ch), buf.blob.channels[ch]);
+}
+
+void test_fewer_channels_default_the_rest() {
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS - 1, sizeof(ChannelConfig));
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(FIELDS, report.defaulted);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS - 1; ch++) assertChannel(sampleChannel(ch), buf.blob.channels[ch]);
+    assertChannel(expectedChannel(NUM_CHANNELS - 1, 0), buf.blob.channels[NUM_CHANNELS - 1]);
+}
+
+void test_more_channels_keep_the_first() {
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS + 1, sizeof(ChannelConfig));
+    TEST_ASSERT_TRUE(length <= sizeof(buf.raw));
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(0, report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(sampleChannel(ch), buf.blob.channels[ch]);
+}
+
+void test_newer_version_keeps_known_fields() {
+    // Более новая прошивка добавила поле в конец канала
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION + 1, NUM_CHANNELS, sizeof(ChannelConfig) + 4);
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_VERSION + 1, report.fromVersion);
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(0, report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(sampleChannel(ch), buf.blob.channels[ch]);
+}
+
+void test_out_of_range_fields_are_defaulted() {
+    ConfigLoadBuffer buf;
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS, sizeof(ChannelConfig));
+    ChannelConfig* channels = buf.blob.channels;
+    channels[0].setpoint = NAN;
+    channels[1].kp = -1.0f;
+    channels[1].calibrationOffset = MAX_CALIB_OFFSET * 2;
+    channels[2].pidFlags = 0x80;
+    channels[2].setpoint = 450.0f;  // В пределах MAX_SETPOINT, но выше maxSetpoint канала
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_FALSE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(5, report.defaulted);
+
+    ChannelConfig expected[NUM_CHANNELS];
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) expected[ch] = sampleChannel(ch);
+    expected[0].setpoint = DEFAULT_SETPOINT;
+    expected[1].kp = PID_KP;
+    expected[1].calibrationOffset = 0.0f;
+    expected[2].pidFlags = 0;
+    expected[2].setpoint = expected[2].maxSetpoint;
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(expected[ch], channels[ch]);
+}
+
+void test_v0_record_migrates() {
+    ConfigLoadBuffer buf;
+    float setpoints[NUM_CHANNELS];
+    float offsets[NUM_CHANNELS];
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+        setpoints[ch] = sampleChannel(ch).setpoint;
+        offsets[ch] = sampleChannel(ch).calibrationOffset;
+    }
+    memcpy(buf.raw, setpoints, sizeof(setpoints));
+    memcpy(buf.raw + sizeof(setpoints), offsets, sizeof(offsets));
+
+    ConfigLoadReport report;
+    TEST_ASSERT_TRUE(configDecode(buf, sizeof(setpoints) + sizeof(offsets), CONFIG_RECORD_TAG_V0, report));
+    TEST_ASSERT_EQUAL_UINT16(0, report.fromVersion);
+    TEST_ASSERT_TRUE(report.migrated);
+    TEST_ASSERT_EQUAL_UINT16(NUM_CHANNELS * (FIELDS - 2), report.defaulted);
+    assertCurrentHeader(buf.blob);
+    for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) assertChannel(expectedChannel(ch, 2), buf.blob.channels[ch]);
+}
+
+void test_malformed_record_falls_back_to_defaults() {
+    ConfigBlob defaults;
+    configDefaults(defaults);
+    ConfigLoadBuffer buf;
+    ConfigLoadReport report;
+
+    // Шаг не кратен 4
+    size_t length = buildRecord(buf, CONFIG_VERSION, NUM_CHANNELS, sizeof(ChannelConfig) + 2);
+    TEST_ASSERT_FALSE(configDecode(buf, length, CONFIG_RECORD_TAG, report));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &buf.blob, sizeof(ConfigBlob));
+
+    // Запись V0 другой длины (другое число каналов)
+    memset(buf.raw, 0, sizeof(buf.raw));
+    TEST_ASSERT_FALSE(configDecode(buf, 2 * (NUM_CHANNELS + 1) * sizeof(float), CONFIG_RECORD_TAG_V0, report));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &buf.blob, sizeof(ConfigBlob));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_current_layout_round_trip);
+    RUN_TEST(test_shorter_stride_defaults_missing_fields);
+    RUN_TEST(test_longer_stride_drops_unknown_fields);
+    RUN_TEST(test_fewer_channels_default_the_rest);
+    RUN_TEST(test_more_channels_keep_the_first);
+    RUN_TEST(test_newer_version_keeps_known_fields);
+    RUN_TEST(test_out_of_range_fields_are_defaulted);
+    RUN_TEST(test_v0_record_migrates);
+    RUN_TEST(test_malformed_record_falls_back_to_defaults);
+    return UNITY_END();
+}
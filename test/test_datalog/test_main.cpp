@@ -0,0 +1,340 @@
+// test_main.cpp
+// Журнал температур: кодек блоков (DataLogCodec) и кольцо блоков (DataLog) поверх файловой
+// имитации флеш (FileFlash) - ключевые кадры после пропусков, заполнение блока, оборванный блок
+// и продолжение записи после перезагрузки, когда кольцо уже обернулось.
+// Запуск: pio test -e native -f test_datalog
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "FlashRegion.h"
+#include "DataLog.h"
+
+static const char* IMAGE = "test_datalog.bin";
+static const uint8_t CHANNELS = 3;
+static const uint16_t PERIOD_MS = 125;
+// Два блока на сектор: запись в первый блок сектора стирает сектор целиком
+static const size_t SECTOR_SIZE = 2 * LOG_BLOCK_SIZE;
+static const size_t SECTOR_COUNT = 4;
+static const uint32_t BLOCKS = SECTOR_COUNT * SECTOR_SIZE / LOG_BLOCK_SIZE;
+
+// Кадр с медленно меняющимися температурами, редкими сменами уставки и флагов
+// и время, согласованное с периодом (как у задачи управления)
+static LogFrame makeFrame(uint32_t cycle, uint32_t timeMs) {
+    LogFrame f;
+    memset(&f, 0, sizeof(f));
+    f.cycle = cycle;
+    f.timeMs = timeMs;
+    for (uint8_t c = 0; c < CHANNELS; c++) {
+        LogSample& s = f.ch[c];
+        s.temp = static_cast<int16_t>(1000 * (c + 1) + (cycle * (3 + c)) % 40 - 20);
+        s.setpoint = static_cast<int16_t>(1000 * (c + 1) + 50 * ((cycle / 40) % 3));
+        s.duty = static_cast<uint8_t>(cycle * (13 + c));
+        s.flags = static_cast<uint8_t>((cycle / 17 + c) % 8);
+    }
+    if (cycle % 29 == 0) f.ch[1].temp = LOG_TEMP_INVALID;
+    return f;
+}
+
+// Последовательность кадров: подряд, с небольшими пропусками, с пропуском ровно LOG_MAX_CYCLE_DELTA
+// (ещё разностный кадр) и с пропусками длиннее него (ключевой кадр, время с произвольным сдвигом)
+static std::vector<LogFrame> makeFrames(size_t count) {
+    std::vector<LogFrame> frames;
+    uint32_t cycle = 1000;
+    uint32_t timeMs = cycle * PERIOD_MS;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t delta = 1;
+        if (i % 50 == 10) delta = 5;
+        if (i % 50 == 20) delta = LOG_MAX_CYCLE_DELTA;
+        if (i % 50 == 30) delta = LOG_MAX_CYCLE_DELTA + 1;
+        if (i % 50 == 40) delta = 10000;
+        cycle += delta;
+        timeMs += delta <= LOG_MAX_CYCLE_DELTA ? delta * PERIOD_MS : delta * PERIOD_MS + 777;
+        frames.push_back(makeFrame(cycle, timeMs));
+    }
+    return frames;
+}
+
+static void assertFrame(const LogFrame& expected, const LogFrame& actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.cycle, actual.cycle);
+    TEST_ASSERT_EQUAL_UINT32(expected.timeMs, actual.timeMs);
+    for (uint8_t c = 0; c < CHANNELS; c++) {
+        TEST_ASSERT_EQUAL_INT16(expected.ch[c].temp, actual.ch[c].temp);
+        TEST_ASSERT_EQUAL_INT16(expected.ch[c].setpoint, actual.ch[c].setpoint);
+        TEST_ASSERT_EQUAL_UINT8(expected.ch[c].duty, actual.ch[c].duty);
+        TEST_ASSERT_EQUAL_UINT8(expected.ch[c].flags, actual.ch[c].flags);
+    }
+}
+
+static void decodeAll(const uint8_t* block, std::vector<LogFrame>& out) {
+    LogDecoder decoder(block);
+    LogFrame f;
+    while (decoder.next(f)) out.push_back(f);
+}
+
+static void readBlock(FlashRegion& flash, uint32_t index, uint8_t* block) {
+    TEST_ASSERT_TRUE(flash.read(index * LOG_BLOCK_SIZE, block, LOG_BLOCK_SIZE));
+}
+
+// Номер блока по заголовку на флеш; -1 - блока нет или он не проходит проверку CRC
+static int32_t blockSequence(FlashRegion& flash, uint32_t index) {
+    uint8_t block[LOG_BLOCK_SIZE];
+    LogBlockHeader h;
+    if (!flash.read(index * LOG_BLOCK_SIZE, block, sizeof(block)) || !logBlockValid(block, h)) return -1;
+    return static_cast<int32_t>(h.sequence);
+}
+
+// Блок из одного кадра: номер кадра - номер блока, чтобы сверять содержимое после перезагрузки
+static bool commitMarked(DataLog& log, uint32_t mark) {
+    LogFrame f = makeFrame(mark, mark * PERIOD_MS);
+    return log.append(f) && log.commit();
+}
+
+void setUp() {
+    remove(IMAGE);
+}
+
+void tearDown() {
+    remove(IMAGE);
+}
+
+void test_codec_round_trip_across_blocks_and_gaps() {
+    std::vector<LogFrame> frames = makeFrames(400);
+    std::vector<LogFrame> decoded;
+    LogEncoder encoder(CHANNELS, PERIOD_MS);
+    uint32_t sequence = 0;
+    encoder.start(sequence, 7);
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (encoder.append(frames[i])) continue;
+        decodeAll(encoder.finish(), decoded);
+        encoder.start(++sequence, 7);
+        TEST_ASSERT_TRUE(encoder.append(frames[i]));
+    }
+    const uint8_t* last = encoder.finish();
+    decodeAll(last, decoded);
+
+    TEST_ASSERT_TRUE(sequence > 0);
+    LogDecoder decoder(last);
+    TEST_ASSERT_TRUE(decoder.valid());
+    TEST_ASSERT_EQUAL_UINT32(sequence, decoder.header().sequence);
+    TEST_ASSERT_EQUAL_UINT16(7, decoder.header().boot);
+    TEST_ASSERT_EQUAL_UINT16(PERIOD_MS, decoder.header().periodMs);
+    TEST_ASSERT_EQUAL_UINT8(CHANNELS, decoder.header().channels);
+
+    TEST_ASSERT_EQUAL_UINT32(frames.size(), decoded.size());
+    for (size_t i = 0; i < frames.size(); i++) assertFrame(frames[i], decoded[i]);
+}
+
+void test_gap_forces_key_frame() {
+    LogEncoder encoder(CHANNELS, PERIOD_MS);
+    encoder.start(0, 0);
+    LogFrame a = makeFrame(100, 100 * PERIOD_MS);
+    LogFrame b = makeFrame(100 + LOG_MAX_CYCLE_DELTA, (100 + LOG_MAX_CYCLE_DELTA) * PERIOD_MS);
+    LogFrame c = makeFrame(b.cycle + LOG_MAX_CYCLE_DELTA + 1, 123456);
+    TEST_ASSERT_TRUE(encoder.append(a));
+    size_t keySize = encoder.used();
+    TEST_ASSERT_TRUE(encoder.append(b));
+    size_t deltaSize = encoder.used() - keySize;
+    TEST_ASSERT_TRUE(encoder.append(c));
+    size_t gapSize = encoder.used() - keySize - deltaSize;
+
+    // Первый байт записи - head: разностный кадр несёт cycleDelta << 1, ключевой - 1
+    const uint8_t* block = encoder.finish();
+    TEST_ASSERT_EQUAL_UINT8(1, block[sizeof(LogBlockHeader)]);
+    TEST_ASSERT_EQUAL_UINT8(LOG_MAX_CYCLE_DELTA << 1, block[keySize]);
+    TEST_ASSERT_EQUAL_UINT8(1, block[keySize + deltaSize]);
+    TEST_ASSERT_TRUE(gapSize > deltaSize);
+
+    // Время ключевого кадра хранится как есть, а не выводится из периода
+    std::vector<LogFrame> decoded;
+    decodeAll(block, decoded);
+    TEST_ASSERT_EQUAL_UINT32(3, decoded.size());
+    assertFrame(a, decoded[0]);
+    assertFrame(b, decoded[1]);
+    assertFrame(c, decoded[2]);
+}
+
+void test_full_block_rejects_frame_and_keeps_contents() {
+    std::vector<LogFrame> frames = makeFrames(400);
+    LogEncoder encoder(CHANNELS, PERIOD_MS);
+    encoder.start(0, 0);
+    size_t accepted = 0;
+    while (accepted < frames.size() && encoder.append(frames[accepted])) accepted++;
+    TEST_ASSERT_TRUE(accepted < frames.size());
+    TEST_ASSERT_EQUAL_UINT16(accepted, encoder.frames());
+
+    // Отказ не меняет блок: повторная попытка тоже отказ, заполнение не растёт
+    size_t used = encoder.used();
+    TEST_ASSERT_TRUE(used <= LOG_BLOCK_SIZE);
+    TEST_ASSERT_TRUE(used + logMaxRecordSize(CHANNELS) > LOG_BLOCK_SIZE);
+    TEST_ASSERT_FALSE(encoder.append(frames[accepted]));
+    TEST_ASSERT_EQUAL_UINT32(used, encoder.used());
+
+    const uint8_t* block = encoder.finish();
+    for (size_t k = used; k < LOG_BLOCK_SIZE; k++) TEST_ASSERT_EQUAL_UINT8(0xFF, block[k]);
+    std::vector<LogFrame> decoded;
+    decodeAll(block, decoded);
+    TEST_ASSERT_EQUAL_UINT32(accepted, decoded.size());
+    for (size_t i = 0; i < accepted; i++) assertFrame(frames[i], decoded[i]);
+
+    // Отвергнутый кадр открывает следующий блок ключевым кадром
+    encoder.start(1, 0);
+    TEST_ASSERT_TRUE(encoder.append(frames[accepted]));
+    decoded.clear();
+    decodeAll(encoder.finish(), decoded);
+    TEST_ASSERT_EQUAL_UINT32(1, decoded.size());
+    assertFrame(frames[accepted], decoded[0]);
+}
+
+void test_torn_block_fails_crc() {
+    std::vector<LogFrame> frames = makeFrames(20);
+    LogEncoder encoder(CHANNELS, PERIOD_MS);
+    encoder.start(5, 0);
+    for (size_t i = 0; i < frames.size(); i++) TEST_ASSERT_TRUE(encoder.append(frames[i]));
+    size_t used = encoder.used();
+    uint8_t block[LOG_BLOCK_SIZE];
+    memcpy(block, encoder.finish(), sizeof(block));
+    LogBlockHeader h;
+    TEST_ASSERT_TRUE(logBlockValid(block, h));
+
+    // Запись оборвалась на середине записей: хвост остался стёртым
+    uint8_t torn[LOG_BLOCK_SIZE];
+    memcpy(torn, block, sizeof(torn));
+    memset(torn + used / 2, 0xFF, LOG_BLOCK_SIZE - used / 2);
+    TEST_ASSERT_FALSE(logBlockValid(torn, h));
+    LogDecoder tornDecoder(torn);
+    LogFrame f;
+    TEST_ASSERT_FALSE(tornDecoder.valid());
+    TEST_ASSERT_FALSE(tornDecoder.next(f));
+
+    // Один изменённый бит в записях
+    memcpy(torn, block, sizeof(torn));
+    torn[sizeof(LogBlockHeader) + 3] ^= 0x04;
+    TEST_ASSERT_FALSE(logBlockValid(torn, h));
+}
+
+void test_log_writes_and_reads_back() {
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    DataLog log(flash);
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_TRUE(log.begin(CHANNELS, PERIOD_MS));
+    DataLogStats st = log.stats();
+    TEST_ASSERT_EQUAL_UINT32(BLOCKS, st.blocks);
+    TEST_ASSERT_EQUAL_UINT32(0, st.sequence);
+    TEST_ASSERT_EQUAL_UINT16(0, st.boot);
+
+    // Кадры копятся, пока блок не заполнится; commit() пишет его и начинает следующий
+    std::vector<LogFrame> frames = makeFrames(200);
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (log.append(frames[i])) continue;
+        TEST_ASSERT_TRUE(log.commit());
+        TEST_ASSERT_EQUAL_UINT16(0, log.pendingFrames());
+        TEST_ASSERT_TRUE(log.append(frames[i]));
+    }
+    TEST_ASSERT_TRUE(log.commit());
+    st = log.stats();
+    TEST_ASSERT_TRUE(st.writes > 1 && st.writes <= BLOCKS);
+    TEST_ASSERT_EQUAL_UINT32(frames.size(), st.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, st.failures);
+
+    std::vector<LogFrame> decoded;
+    uint8_t block[LOG_BLOCK_SIZE];
+    for (uint32_t b = 0; b < st.writes; b++) {
+        readBlock(flash, b, block);
+        TEST_ASSERT_EQUAL_INT32(b, blockSequence(flash, b));
+        decodeAll(block, decoded);
+    }
+    TEST_ASSERT_EQUAL_UINT32(frames.size(), decoded.size());
+    for (size_t i = 0; i < frames.size(); i++) assertFrame(frames[i], decoded[i]);
+
+    // Пустой блок не пишется
+    TEST_ASSERT_TRUE(log.commit());
+    TEST_ASSERT_EQUAL_UINT32(st.writes, log.stats().writes);
+}
+
+void test_begin_resumes_after_newest_across_wrap() {
+    // BLOCKS + 3 блоков: кольцо обернулось, новейший блок (номер BLOCKS + 2) лежит в секторе 1
+    const uint32_t written = BLOCKS + 3;
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        DataLog log(flash);
+        TEST_ASSERT_TRUE(flash.begin() && log.begin(CHANNELS, PERIOD_MS));
+        for (uint32_t seq = 0; seq < written; seq++) TEST_ASSERT_TRUE(commitMarked(log, seq));
+        TEST_ASSERT_EQUAL_UINT32(written, log.stats().sequence);
+        // Повторный вход в сектор стирает его: вытесняются оба старых блока сектора
+        TEST_ASSERT_EQUAL_UINT32(2, flash.eraseCount(0));
+        TEST_ASSERT_EQUAL_UINT32(2, flash.eraseCount(1));
+        TEST_ASSERT_EQUAL_UINT32(1, flash.eraseCount(2));
+    }
+
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_EQUAL_INT32(BLOCKS, blockSequence(flash, 0));
+    TEST_ASSERT_EQUAL_INT32(BLOCKS + 1, blockSequence(flash, 1));
+    TEST_ASSERT_EQUAL_INT32(BLOCKS + 2, blockSequence(flash, 2));
+    TEST_ASSERT_EQUAL_INT32(-1, blockSequence(flash, 3));
+    TEST_ASSERT_EQUAL_INT32(4, blockSequence(flash, 4));
+
+    DataLog log(flash);
+    TEST_ASSERT_TRUE(log.begin(CHANNELS, PERIOD_MS));
+    DataLogStats st = log.stats();
+    TEST_ASSERT_EQUAL_UINT32(written, st.sequence);
+    TEST_ASSERT_EQUAL_UINT16(1, st.boot);
+
+    // Следующий блок - сразу за новейшим, во второй блок сектора 1: без стирания, старое не теряется
+    TEST_ASSERT_TRUE(commitMarked(log, written));
+    TEST_ASSERT_EQUAL_UINT32(0, log.stats().erases);
+    TEST_ASSERT_EQUAL_INT32(written, blockSequence(flash, 3));
+    TEST_ASSERT_EQUAL_INT32(4, blockSequence(flash, 4));
+
+    uint8_t block[LOG_BLOCK_SIZE];
+    readBlock(flash, 3, block);
+    LogDecoder decoder(block);
+    TEST_ASSERT_EQUAL_UINT16(1, decoder.header().boot);
+    LogFrame f;
+    TEST_ASSERT_TRUE(decoder.next(f));
+    assertFrame(makeFrame(written, written * PERIOD_MS), f);
+
+    // Следующий - в сектор 2, который при этом стирается
+    TEST_ASSERT_TRUE(commitMarked(log, written + 1));
+    TEST_ASSERT_EQUAL_UINT32(1, log.stats().erases);
+    TEST_ASSERT_EQUAL_INT32(written + 1, blockSequence(flash, 4));
+    TEST_ASSERT_EQUAL_INT32(-1, blockSequence(flash, 5));
+}
+
+void test_begin_resumes_after_torn_newest_block() {
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        DataLog log(flash);
+        TEST_ASSERT_TRUE(flash.begin() && log.begin(CHANNELS, PERIOD_MS));
+        for (uint32_t seq = 0; seq < 3; seq++) TEST_ASSERT_TRUE(commitMarked(log, seq));
+        // Запись блока 2 оборвалась: часть записей не дописана (нули поверх данных)
+        uint8_t zeros[8] = {0};
+        TEST_ASSERT_TRUE(flash.write(2 * LOG_BLOCK_SIZE + sizeof(LogBlockHeader), zeros, sizeof(zeros)));
+    }
+
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    DataLog log(flash);
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_EQUAL_INT32(1, blockSequence(flash, 1));
+    TEST_ASSERT_EQUAL_INT32(-1, blockSequence(flash, 2));
+
+    // Оборванный блок отвергает декодер, но номер из его заголовка занят: запись идёт за ним
+    TEST_ASSERT_TRUE(log.begin(CHANNELS, PERIOD_MS));
+    TEST_ASSERT_EQUAL_UINT32(3, log.stats().sequence);
+    TEST_ASSERT_TRUE(commitMarked(log, 3));
+    TEST_ASSERT_EQUAL_INT32(3, blockSequence(flash, 3));
+    TEST_ASSERT_EQUAL_INT32(1, blockSequence(flash, 1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_codec_round_trip_across_blocks_and_gaps);
+    RUN_TEST(test_gap_forces_key_frame);
+    RUN_TEST(test_full_block_rejects_frame_and_keeps_contents);
+    RUN_TEST(test_torn_block_fails_crc);
+    RUN_TEST(test_log_writes_and_reads_back);
+    RUN_TEST(test_begin_resumes_after_newest_across_wrap);
+    RUN_TEST(test_begin_resumes_after_torn_newest_block);
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+// test_main.cpp
+// Тесты TemperatureFilter на хосте: подавление шума и переходная характеристика.
+// Запуск: pio test -e native -f test_filter
+#include <unity.h>
+#include <math.h>
+#include "TemperatureFilter.h"
+#include "Config.h"
+
+// Частота отсчётов канала: датчик опрашивается раз в два цикла задачи управления (см. HeaterChannel)
+static const float FS = 1000.0f / (2 * CONTROL_PERIOD_MS);
+
+void setUp() {}
+void tearDown() {}
+
+// Постоянные 200 °C плюс равномерный шум ±1 °C, квантованный по 0.25 °C (как у MAX6675)
+static float noisySample(uint32_t& seed) {
+    seed = seed * 1664525UL + 1013904223UL;
+    float noise = ((seed >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+    return roundf((200.0f + noise) * 4.0f) / 4.0f;
+}
+
+// Подавление шума в дБ для фильтра, уже настроенного вызывающим
+static float attenuationDb(TemperatureFilter& filter) {
+    const int samples = 4000;
+    uint32_t seed = 12345;
+    double inSq = 0, outSq = 0;
+    for (int i = 0; i < samples; i++) {
+        float x = noisySample(seed);
+        float y = filter.apply(x);
+        if (i >= samples / 10) {  // Без переходного процесса
+            inSq += (x - 200.0) * (x - 200.0);
+            outSq += (y - 200.0) * (y - 200.0);
+        }
+    }
+    return 10.0f * log10f(inSq / (outSq > 0 ? outSq : 1e-12));
+}
+
+static void configureDefault(TemperatureFilter& filter) {
+    filter.configure(0, FILTER_MEDIAN, FILTER_MEDIAN_SIZE, FS);
+    filter.configure(1, FILTER_SMOOTH_TYPE, FILTER_SMOOTH_PARAM, FS);
+}
+
+// Переходная характеристика на скачок 25 -> 125 °C: отсчётов до 50 % и до 90 %, перерегулирование
+struct StepResponse {
+    int delay50;
+    int rise90;
+    float overshoot;
+    float final;
+};
+
+static StepResponse stepResponse(TemperatureFilter& filter) {
+    StepResponse r = {-1, -1, 0.0f, 0.0f};
+    filter.reset(25.0f);
+    for (int i = 0; i < 200; i++) {
+        float y = filter.apply(125.0f);
+        if (r.delay50 < 0 && y >= 75.0f) r.delay50 = i + 1;
+        if (r.rise90 < 0 && y >= 115.0f) r.rise90 = i + 1;
+        if (y - 125.0f > r.overshoot) r.overshoot = y - 125.0f;
+        r.final = y;
+    }
+    return r;
+}
+
+void test_none_passes_through() {
+    TemperatureFilter filter;
+    filter.configure(0, FILTER_NONE, 0, FS);
+    filter.configure(1, FILTER_NONE, 0, FS);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 123.25f, filter.apply(123.25f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, -4.5f, filter.apply(-4.5f));
+}
+
+void test_median_rejects_single_spike() {
+    TemperatureFilter filter;
+    filter.configure(0, FILTER_MEDIAN, 3, FS);
+    filter.configure(1, FILTER_NONE, 0, FS);
+    for (int i = 0; i < 5; i++) filter.apply(200.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 200.0f, filter.apply(1023.75f));  // Выброс (обрыв линии DO)
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 200.0f, filter.apply(200.0f));
+}
+
+void test_first_sample_primes_without_transient() {
+    TemperatureFilter filter;
+    configureDefault(filter);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 180.0f, filter.apply(180.0f));
+    for (int i = 0; i < 20; i++) TEST_ASSERT_FLOAT_WITHIN(1e-3, 180.0f, filter.apply(180.0f));
+}
+
+void test_smoothing_attenuates_noise() {
+    struct { FilterType type; float param; float minDb; } cases[] = {
+        {FILTER_EMA, 0.2f, 9.0f},
+        {FILTER_IIR1, 0.2f, 7.5f},
+        {FILTER_IIR2, 0.2f, 9.0f},
+    };
+    for (auto& c : cases) {
+        TemperatureFilter filter;
+        filter.configure(0, c.type, c.param, FS);
+        filter.configure(1, FILTER_NONE, 0, FS);
+        float db = attenuationDb(filter);
+        TEST_ASSERT_TRUE_MESSAGE(db >= c.minDb, "недостаточное подавление шума");
+    }
+}
+
+void test_default_chain_attenuation() {
+    TemperatureFilter filter;
+    configureDefault(filter);
+    TEST_ASSERT_TRUE_MESSAGE(attenuationDb(filter) >= 6.0f, "цепочка по умолчанию: подавление шума < 6 дБ");
+}
+
+// Запаздывание цепочки по умолчанию входит в контур PID: держим его в пределах, указанных в Config.h
+void test_default_chain_step_lag() {
+    TemperatureFilter filter;
+    configureDefault(filter);
+    StepResponse r = stepResponse(filter);
+    TEST_ASSERT_TRUE_MESSAGE(r.delay50 > 0 && r.delay50 <= 4, "50 % скачка позже 4 отсчётов (1 с)");
+    TEST_ASSERT_TRUE_MESSAGE(r.rise90 > 0 && r.rise90 <= 7, "90 % скачка позже 7 отсчётов (1.75 с)");
+    TEST_ASSERT_TRUE_MESSAGE(r.overshoot <= 0.05f * 100.0f, "перерегулирование больше 5 %");
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 125.0f, r.final);
+}
+
+void test_iir_unity_dc_gain() {
+    FilterType types[] = {FILTER_EMA, FILTER_IIR1, FILTER_IIR2};
+    for (FilterType t : types) {
+        TemperatureFilter filter;
+        filter.configure(0, t, 0.3f, FS);
+        filter.configure(1, FILTER_NONE, 0, FS);
+        StepResponse r = stepResponse(filter);
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 125.0f, r.final);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_none_passes_through);
+    RUN_TEST(test_median_rejects_single_spike);
+    RUN_TEST(test_first_sample_primes_without_transient);
+    RUN_TEST(test_smoothing_attenuates_noise);
+    RUN_TEST(test_default_chain_attenuation);
+    RUN_TEST(test_default_chain_step_lag);
+    RUN_TEST(test_iir_unity_dc_gain);
+    return UNITY_END();
+}
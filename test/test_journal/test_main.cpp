@@ -0,0 +1,204 @@
+// test_main.cpp
+// Журнал настроек (SettingsJournal) поверх файловой имитации флеш (FileFlash):
+// смена секторов, оборванные заголовки и записи, откат к предыдущему поколению.
+// Запуск: pio test -e native -f test_journal
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "FlashRegion.h"
+#include "SettingsJournal.h"
+
+static const char* IMAGE = "test_journal.bin";
+static const size_t SECTOR_SIZE = 512;
+static const size_t SECTOR_COUNT = 4;
+// Размеры заголовков из формата SettingsJournal: сектор {magic, generation, ~generation}, запись {length, tag, crc}
+static const uint32_t SECTOR_HEADER = 12;
+static const uint32_t RECORD_HEADER = 8;
+static const uint16_t TAG = 0x5354;
+
+// Полный снимок настроек, как у EEPROMHandler: номер и тело, зависящее от номера
+struct Payload {
+    uint32_t seq;
+    uint8_t body[56];
+};
+
+static Payload makePayload(uint32_t seq) {
+    Payload p;
+    p.seq = seq;
+    for (size_t k = 0; k < sizeof(p.body); k++) p.body[k] = static_cast<uint8_t>(seq * 31 + k);
+    return p;
+}
+
+// Номер последней записи после "перезагрузки": новый FileFlash и журнал над тем же образом.
+// 0 - записей нет или данные не совпали с ожидаемыми для номера.
+static uint32_t reloadSeq() {
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    if (!flash.begin() || !journal.begin() || !journal.hasRecord()) return 0;
+    Payload p;
+    uint16_t tag = 0;
+    if (journal.load(&p, sizeof(p), &tag) != sizeof(p) || tag != TAG) return 0;
+    Payload expected = makePayload(p.seq);
+    return memcmp(&p, &expected, sizeof(p)) == 0 ? p.seq : 0;
+}
+
+static bool appendSeq(SettingsJournal& journal, uint32_t seq) {
+    Payload p = makePayload(seq);
+    return journal.append(TAG, &p, sizeof(p));
+}
+
+void setUp() {
+    remove(IMAGE);
+}
+
+void tearDown() {
+    remove(IMAGE);
+}
+
+void test_empty_image_has_no_record() {
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_FALSE(journal.hasRecord());
+    TEST_ASSERT_TRUE(appendSeq(journal, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, reloadSeq());
+}
+
+// Много записей: журнал ходит по кругу, последняя запись читается после каждой перезагрузки,
+// стирания распределены по секторам равномерно
+void test_rotation_spreads_erases() {
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    TEST_ASSERT_TRUE(flash.begin());
+    TEST_ASSERT_TRUE(journal.begin());
+    const uint32_t total = 200;
+    for (uint32_t seq = 1; seq <= total; seq++) {
+        TEST_ASSERT_TRUE(appendSeq(journal, seq));
+        if (seq % 3 == 0) journal.maintain();  // Фоновое стирание между сохранениями
+        if (seq % 17 == 0) TEST_ASSERT_EQUAL_UINT32(seq, reloadSeq());
+    }
+    TEST_ASSERT_EQUAL_UINT32(total, reloadSeq());
+
+    // 7 записей на сектор: ~29 смен сектора на 4 сектора
+    JournalStats st = journal.stats();
+    TEST_ASSERT_TRUE(st.generation > 20);
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (size_t s = 0; s < SECTOR_COUNT; s++) {
+        uint32_t n = flash.eraseCount(s);
+        if (n < lo) lo = n;
+        if (n > hi) hi = n;
+    }
+    TEST_ASSERT_TRUE(lo > 0);
+    TEST_ASSERT_LESS_OR_EQUAL(1, hi - lo);
+}
+
+// Питание пропало между данными и заголовком записи: заголовок записан частично
+void test_torn_record_header_falls_back() {
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        SettingsJournal journal(flash);
+        TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+        TEST_ASSERT_TRUE(appendSeq(journal, 1));
+        TEST_ASSERT_TRUE(appendSeq(journal, 2));
+
+        // Данные третьей записи и только поле длины её заголовка
+        JournalStats st = journal.stats();
+        uint32_t at = st.sector * SECTOR_SIZE + st.used;
+        Payload p = makePayload(3);
+        uint16_t length = sizeof(p);
+        TEST_ASSERT_TRUE(flash.write(at + RECORD_HEADER, &p, sizeof(p)));
+        TEST_ASSERT_TRUE(flash.write(at, &length, sizeof(length)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, reloadSeq());
+
+    // Сектор с оборванной записью закрыт: следующая запись уходит в новый сектор и читается
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+    uint32_t before = journal.stats().sector;
+    TEST_ASSERT_TRUE(appendSeq(journal, 4));
+    TEST_ASSERT_TRUE(journal.stats().sector != before);
+    TEST_ASSERT_EQUAL_UINT32(4, reloadSeq());
+}
+
+// Заголовок записи полный, но данные записались не все (часть битов не сброшена) - CRC не сходится
+void test_torn_record_data_falls_back() {
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        SettingsJournal journal(flash);
+        TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+        TEST_ASSERT_TRUE(appendSeq(journal, 1));
+        TEST_ASSERT_TRUE(appendSeq(journal, 2));
+        JournalStats st = journal.stats();
+        uint32_t at = st.sector * SECTOR_SIZE + st.used;
+        TEST_ASSERT_TRUE(appendSeq(journal, 3));
+        // Порча тела последней записи: запись во флеш только сбрасывает биты
+        uint8_t zeros[8] = {0};
+        TEST_ASSERT_TRUE(flash.write(at + RECORD_HEADER + 20, zeros, sizeof(zeros)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, reloadSeq());
+}
+
+// Смена сектора оборвалась на заголовке нового сектора: остаётся предыдущее поколение
+void test_torn_sector_header_keeps_previous_generation() {
+    uint32_t next;
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        SettingsJournal journal(flash);
+        TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+        for (uint32_t seq = 1; seq <= 5; seq++) TEST_ASSERT_TRUE(appendSeq(journal, seq));
+        next = (journal.stats().sector + 1) % SECTOR_COUNT;
+        // Новый сектор стёрт, из заголовка успел записаться только magic
+        TEST_ASSERT_TRUE(flash.eraseSector(next));
+        uint32_t magic = 0x4E524A53UL;
+        TEST_ASSERT_TRUE(flash.write(next * SECTOR_SIZE, &magic, sizeof(magic)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, reloadSeq());
+
+    // Журнал продолжает писать поверх недописанного сектора
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+    for (uint32_t seq = 6; seq <= 20; seq++) TEST_ASSERT_TRUE(appendSeq(journal, seq));
+    TEST_ASSERT_EQUAL_UINT32(20, reloadSeq());
+}
+
+// Новый сектор открыт (заголовок нового поколения корректен), но перенос записи в него оборвался:
+// последняя корректная запись - в секторе предыдущего поколения
+void test_recovers_record_from_older_generation() {
+    uint32_t newSector;
+    {
+        FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+        SettingsJournal journal(flash);
+        TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+        // 7 записей заполняют сектор, восьмая открывает следующий
+        for (uint32_t seq = 1; seq <= 8; seq++) TEST_ASSERT_TRUE(appendSeq(journal, seq));
+        JournalStats st = journal.stats();
+        TEST_ASSERT_EQUAL_UINT32(SECTOR_HEADER + RECORD_HEADER + sizeof(Payload), st.used);
+        newSector = st.sector;
+        // Заголовок восьмой записи испорчен: в новом поколении корректных записей нет
+        uint8_t zeros[4] = {0};
+        TEST_ASSERT_TRUE(flash.write(newSector * SECTOR_SIZE + SECTOR_HEADER + 4, zeros, sizeof(zeros)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(7, reloadSeq());
+
+    // Активным остаётся новое поколение, а новая запись снова читается
+    FileFlash flash(IMAGE, SECTOR_SIZE, SECTOR_COUNT);
+    SettingsJournal journal(flash);
+    TEST_ASSERT_TRUE(flash.begin() && journal.begin());
+    TEST_ASSERT_EQUAL_UINT32(newSector, journal.stats().sector);
+    TEST_ASSERT_TRUE(appendSeq(journal, 9));
+    TEST_ASSERT_EQUAL_UINT32(9, reloadSeq());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_image_has_no_record);
+    RUN_TEST(test_rotation_spreads_erases);
+    RUN_TEST(test_torn_record_header_falls_back);
+    RUN_TEST(test_torn_record_data_falls_back);
+    RUN_TEST(test_torn_sector_header_keeps_previous_generation);
+    RUN_TEST(test_recovers_record_from_older_generation);
+    return UNITY_END();
+}
@@ -0,0 +1,160 @@
+// test_main.cpp
+// Объединение уведомлений задачи сохранения (PersistCoalescer) в виртуальном времени.
+// Запуск: pio test -e native -f test_persist
+#include <unity.h>
+#include <vector>
+#include "PersistPolicy.h"
+
+static const uint32_t QUIET = 3000;
+static const uint32_t MAX_DELAY = 30000;
+
+void setUp() {}
+void tearDown() {}
+
+// Сценарий уведомлений: события в заданные моменты, время идёт только в wait()
+class ScriptSource : public PersistSource {
+public:
+    struct Event {
+        uint32_t at;
+        uint32_t events;
+    };
+
+    explicit ScriptSource(uint32_t start = 0) : time(start), next(0) {}
+
+    void add(uint32_t at, uint32_t events) { script.push_back({at, events}); }
+    // count уведомлений DIRTY с шагом step, начиная с from
+    void burst(uint32_t from, int count, uint32_t step) {
+        for (int i = 0; i < count; i++) add(from + i * step, PERSIST_EVENT_DIRTY);
+    }
+
+    uint32_t now() override { return time; }
+
+    bool wait(uint32_t timeout, uint32_t& events) override {
+        if (next < script.size() && (timeout == PERSIST_WAIT_FOREVER || script[next].at - time <= timeout)) {
+            time = script[next].at;
+            events = 0;
+            // Уведомления до пробуждения задачи копятся битами (eSetBits)
+            while (next < script.size() && script[next].at == time) events |= script[next++].events;
+            return true;
+        }
+        if (timeout == PERSIST_WAIT_FOREVER) return false;  // Сценарий исчерпан
+        time += timeout;
+        return false;
+    }
+
+private:
+    uint32_t time;
+    size_t next;
+    std::vector<Event> script;
+};
+
+struct Commit {
+    uint32_t at;
+    uint32_t reason;
+};
+
+// Все проходы сохранения до конца сценария
+static void runScript(ScriptSource& source, std::vector<Commit>& commits) {
+    PersistCoalescer coalescer(source, QUIET, MAX_DELAY);
+    while (uint32_t reason = coalescer.next()) commits.push_back({source.now(), reason});
+    TEST_ASSERT_FALSE(coalescer.dirty());
+}
+
+// Быстрое вращение энкодера: 20 правок через 40 мс - один проход через QUIET после последней
+void test_burst_gives_one_commit() {
+    ScriptSource source(1000);
+    source.burst(1000, 20, 40);
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(1, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(1000 + 19 * 40 + QUIET, commits[0].at);
+    TEST_ASSERT_EQUAL_UINT32(PERSIST_EVENT_DIRTY, commits[0].reason);
+}
+
+// Пачки, разделённые паузой длиннее QUIET, - по проходу на пачку
+void test_separate_bursts_commit_separately() {
+    ScriptSource source;
+    source.burst(0, 10, 100);
+    source.burst(10000, 5, 200);
+    source.burst(20000, 3, 50);
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(3, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(900 + QUIET, commits[0].at);
+    TEST_ASSERT_EQUAL_UINT32(10800 + QUIET, commits[1].at);
+    TEST_ASSERT_EQUAL_UINT32(20100 + QUIET, commits[2].at);
+}
+
+// Правки без пауз: проход не позже MAX_DELAY от первой несохранённой
+void test_continuous_edits_bounded_by_max_delay() {
+    ScriptSource source;
+    source.burst(0, 100, 1000);  // 100 с правок раз в секунду
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(4, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(MAX_DELAY, commits[0].at);
+    // Следующая пачка начинается с первой правки после прохода
+    TEST_ASSERT_EQUAL_UINT32(31000 + MAX_DELAY, commits[1].at);
+    TEST_ASSERT_EQUAL_UINT32(62000 + MAX_DELAY, commits[2].at);
+    TEST_ASSERT_EQUAL_UINT32(99000 + QUIET, commits[3].at);
+}
+
+// Смена режима посреди правок - сразу, вместе с ними; после неё дописывать нечего
+void test_mode_change_commits_immediately() {
+    ScriptSource source;
+    source.burst(0, 5, 100);
+    source.add(450, PERSIST_EVENT_MODE);
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(1, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(450, commits[0].at);
+    TEST_ASSERT_EQUAL_UINT32(PERSIST_EVENT_MODE | PERSIST_EVENT_DIRTY, commits[0].reason);
+}
+
+// Питание без правок - сразу, причина POWER без DIRTY; правки после него пишутся своим проходом
+void test_power_warning_commits_immediately() {
+    ScriptSource source;
+    source.add(500, PERSIST_EVENT_POWER);
+    source.burst(600, 3, 100);
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(2, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(500, commits[0].at);
+    TEST_ASSERT_EQUAL_UINT32(PERSIST_EVENT_POWER, commits[0].reason);
+    TEST_ASSERT_EQUAL_UINT32(800 + QUIET, commits[1].at);
+    TEST_ASSERT_EQUAL_UINT32(PERSIST_EVENT_DIRTY, commits[1].reason);
+}
+
+// Уведомления, пришедшие до пробуждения, объединяются в одно
+void test_coalesced_notification_bits() {
+    ScriptSource source;
+    source.add(100, PERSIST_EVENT_DIRTY);
+    source.add(100, PERSIST_EVENT_MODE);
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(1, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(PERSIST_EVENT_MODE | PERSIST_EVENT_DIRTY, commits[0].reason);
+}
+
+// Переполнение счётчика тиков посреди пачки
+void test_tick_wraparound() {
+    const uint32_t start = UINT32_MAX - 500;
+    ScriptSource source(start);
+    source.burst(start, 20, 40);  // Переполнение на 13-й правке
+    std::vector<Commit> commits;
+    runScript(source, commits);
+    TEST_ASSERT_EQUAL_UINT32(1, commits.size());
+    TEST_ASSERT_EQUAL_UINT32(start + 19 * 40 + QUIET, commits[0].at);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_burst_gives_one_commit);
+    RUN_TEST(test_separate_bursts_commit_separately);
+    RUN_TEST(test_continuous_edits_bounded_by_max_delay);
+    RUN_TEST(test_mode_change_commits_immediately);
+    RUN_TEST(test_power_warning_commits_immediately);
+    RUN_TEST(test_coalesced_notification_bits);
+    RUN_TEST(test_tick_wraparound);
+    return UNITY_END();
+}
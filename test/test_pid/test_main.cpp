@@ -0,0 +1,181 @@
+// test_main.cpp
+// Эквивалентность FixedPID (Q16.16) и эталонного GyverPID (float) на хосте.
+// Оба регулятора получают одинаковые уставку и вход от общей модели объекта, которой управляет эталон;
+// расхождение выхода на каждом шаге не должно превышать PID_MAX_ERROR.
+// Запуск: pio test -e native -f test_pid
+#include <unity.h>
+#include <math.h>
+#include <GyverPID.h>
+#include "FixedPID.h"
+#include "PIDBank.h"
+#include "Config.h"
+
+// Допустимое расхождение выхода - полшага ШИМ: скважность после округления отличается не больше чем на 1.
+// Расхождение набирается в интегральной сумме (округление Ki*dt до Q16.16 и произведений), которая
+// в этой схеме не корректируется обратной связью: за 5000 шагов в режиме ON_RATE - ~0.44, ON_ERROR - ~0.06.
+static const float PID_MAX_ERROR = 0.5f;
+
+void setUp() {}
+void tearDown() {}
+
+struct PidCase {
+    float kp, ki, kd;
+    uint32_t dtMs;
+    bool direction;
+    bool mode;
+    int16_t minOut, maxOut;
+};
+
+// Прогон steps шагов: уставка 200 -> 150 °C на середине, объект первого порядка с шумом датчика 0.25 °C.
+// Возвращает наибольшее расхождение выходов.
+static float maxDivergence(const PidCase& c, int steps) {
+    GyverPID ref(c.kp, c.ki, c.kd, c.dtMs);
+    FixedPID fixed(c.kp, c.ki, c.kd, c.dtMs);
+    ref.setLimits(c.minOut, c.maxOut);
+    fixed.setLimits(c.minOut, c.maxOut);
+    ref.setDirection(c.direction);
+    fixed.setDirection(c.direction);
+    ref.setMode(c.mode);
+    fixed.setMode(c.mode);
+
+    float temp = 25.0f;
+    float maxDiff = 0.0f;
+    uint32_t seed = 1;
+    for (int i = 0; i < steps; i++) {
+        float sp = (i < steps / 2) ? 200.0f : 150.0f;
+        seed = seed * 1664525UL + 1013904223UL;
+        // Вход - как у MAX6675: кратно 0.25 °C, т.е. точно представим и во float, и в Q16.16
+        float input = roundf((temp + ((seed >> 30) - 1.5f) * 0.25f) * 4.0f) / 4.0f;
+
+        ref.setpoint = sp;
+        ref.input = input;
+        float refOut = ref.getResult();
+        float fixedOut = fixed.getResult(sp, input);
+
+        float diff = fabsf(refOut - fixedOut);
+        if (diff > maxDiff) maxDiff = diff;
+        float drive = c.direction ? (c.maxOut - refOut) : refOut;
+        temp += (25.0f + 450.0f * drive / c.maxOut - temp) * (c.dtMs / 60000.0f);
+    }
+    return maxDiff;
+}
+
+static void assertEquivalent(const PidCase& c) {
+    float diff = maxDivergence(c, 5000);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "расхождение %.5f больше %.3f", diff, PID_MAX_ERROR);
+    TEST_ASSERT_TRUE_MESSAGE(diff <= PID_MAX_ERROR, msg);
+}
+
+void test_default_gains_on_error() {
+    assertEquivalent({PID_KP, PID_KI, PID_KD, 2 * CONTROL_PERIOD_MS, false, false, 0, PWM_MAX_DUTY});
+}
+
+void test_on_rate_mode() {
+    assertEquivalent({PID_KP, PID_KI, PID_KD, 2 * CONTROL_PERIOD_MS, false, true, 0, PWM_MAX_DUTY});
+}
+
+void test_reverse_direction() {
+    assertEquivalent({PID_KP, PID_KI, PID_KD, 2 * CONTROL_PERIOD_MS, true, false, 0, PWM_MAX_DUTY});
+}
+
+void test_aggressive_gains_saturate() {
+    // Выход большую часть времени в насыщении: проверяет ограничение интегральной суммы и выхода
+    assertEquivalent({80.0f, 4.0f, 40.0f, 2 * CONTROL_PERIOD_MS, false, false, 0, PWM_MAX_DUTY});
+}
+
+void test_other_dt_and_limits() {
+    assertEquivalent({3.5f, 0.02f, 12.0f, 100, false, false, -100, 100});
+    assertEquivalent({PID_KP, PID_KI, PID_KD, 1000, false, false, 0, PWM_MAX_DUTY});
+}
+
+void test_dt_change_recomputes_gains() {
+    GyverPID ref(PID_KP, PID_KI, PID_KD, 250);
+    FixedPID fixed(PID_KP, PID_KI, PID_KD, 250);
+    ref.setLimits(0, PWM_MAX_DUTY);
+    fixed.setLimits(0, PWM_MAX_DUTY);
+    ref.setDt(500);
+    fixed.setDt(500);
+    ref.setpoint = 100.0f;
+    for (int i = 0; i < 50; i++) {
+        float input = 20.0f + i * 1.5f;
+        ref.input = input;
+        TEST_ASSERT_FLOAT_WITHIN(PID_MAX_ERROR, ref.getResult(), fixed.getResult(100.0f, input));
+    }
+}
+
+void test_integer_output_rounds() {
+    FixedPID fixed(1.0f, 0.0f, 0.0f, 250);
+    fixed.setLimits(0, PWM_MAX_DUTY);
+    fixed.getResult(100.0f, 99.5f);  // P = 0.5 -> 1
+    TEST_ASSERT_EQUAL_INT(1, fixed.getOutput());
+    fixed.getResult(100.0f, 99.75f); // P = 0.25 -> 0
+    TEST_ASSERT_EQUAL_INT(0, fixed.getOutput());
+}
+
+// Канал PIDBank считает тем же ядром, что и FixedPID: выходы совпадают точно.
+void test_bank_matches_fixed() {
+    PIDBank bank;
+    FixedPID fixed(PID_KP, PID_KI, PID_KD, 2 * CONTROL_PERIOD_MS);
+    fixed.setLimits(0, PWM_MAX_DUTY);
+    bank.setSetpoint(0, 180.0f);
+    TickType_t tick = 1000;
+    float input = 25.0f;
+    fixed.getResult(180.0f, input);  // Первый отсчёт: у банка он сам себе предыдущий
+    bank.setInput(0, input, tick);
+    bank.update(1);
+    for (int i = 0; i < 200; i++) {
+        input += 0.75f;
+        tick += pdMS_TO_TICKS(2 * CONTROL_PERIOD_MS);
+        bank.setInput(0, input, tick);
+        TEST_ASSERT_EQUAL_UINT32(1, bank.update(1));
+        fixed.getResult(180.0f, input);
+        TEST_ASSERT_EQUAL_INT(fixed.getOutput(), bank.getOutput(0));
+    }
+}
+
+// Отсчёты без расчёта (STANDBY, автонастройка) двигают предыдущий вход:
+// первый шаг после возврата в работу берёт производную только по последнему интервалу.
+void test_bank_no_derivative_kick_after_standby() {
+    PIDBank bank;
+    bank.setTunings(0, 0.0f, 0.0f, 1.0f);  // Только D: Kd/dt = 4 при dt = 250 мс
+    bank.setLimits(0, -1000, 1000);
+    TickType_t tick = 0;
+    for (int i = 0; i <= 100; i++) {
+        tick += pdMS_TO_TICKS(250);
+        bank.setInput(0, 20.0f + i, tick);  // Нагрев на 100 °C без расчёта
+    }
+    tick += pdMS_TO_TICKS(250);
+    bank.setInput(0, 121.0f, tick);
+    TEST_ASSERT_EQUAL_UINT32(1, bank.update(1));
+    TEST_ASSERT_EQUAL_INT(-4, bank.getOutput(0));  // Изменение на 1 °C за шаг, а не на 121
+}
+
+// Первый отсчёт после запуска и после reset() не даёт броска D
+void test_bank_no_kick_on_first_sample_and_reset() {
+    PIDBank bank;
+    bank.setTunings(0, 0.0f, 0.0f, 1.0f);
+    bank.setLimits(0, -1000, 1000);
+    bank.setInput(0, 150.0f, 100);
+    bank.update(1);
+    TEST_ASSERT_EQUAL_INT(0, bank.getOutput(0));
+    bank.reset(0);
+    bank.setInput(0, 150.0f, 350);
+    bank.update(1);
+    TEST_ASSERT_EQUAL_INT(0, bank.getOutput(0));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_gains_on_error);
+    RUN_TEST(test_on_rate_mode);
+    RUN_TEST(test_reverse_direction);
+    RUN_TEST(test_aggressive_gains_saturate);
+    RUN_TEST(test_other_dt_and_limits);
+    RUN_TEST(test_dt_change_recomputes_gains);
+    RUN_TEST(test_integer_output_rounds);
+    RUN_TEST(test_bank_matches_fixed);
+    RUN_TEST(test_bank_no_derivative_kick_after_standby);
+    RUN_TEST(test_bank_no_kick_on_first_sample_and_reset);
+    return UNITY_END();
+}
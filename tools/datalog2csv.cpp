@@ -0,0 +1,111 @@
+// datalog2csv.cpp
+// Разбор образа раздела журнала температур (datalog) в CSV.
+//
+// Сборка на хосте (из корня проекта):
+//   g++ -std=c++11 -O2 -Isrc tools/datalog2csv.cpp src/DataLogCodec.cpp src/Crc32.cpp -o datalog2csv
+// Образ раздела (смещение и размер - из partitions.csv):
+//   esptool.py read_flash 0x290000 0x15C000 datalog.bin
+// Разбор:
+//   ./datalog2csv datalog.bin > datalog.csv
+//
+// Блоки упорядочиваются по сквозному номеру, повреждённые (по CRC) пропускаются с сообщением в stderr.
+// Столбцы: boot - номер запуска прошивки, cycle - номер цикла управления, time_s - время от запуска,
+// далее по каналам: температура и уставка в °C (пусто - датчик неисправен), скважность 0..255, флаги.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "DataLogCodec.h"
+
+struct BlockRef {
+    uint32_t sequence;
+    long offset;
+};
+
+static void printTenths(int16_t v) {
+    if (v == LOG_TEMP_INVALID) return;
+    int magnitude = v < 0 ? -v : v;
+    printf("%s%d.%d", v < 0 ? "-" : "", magnitude / LOG_TEMP_SCALE, magnitude % LOG_TEMP_SCALE);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s datalog.bin > datalog.csv\n", argv[0]);
+        return 2;
+    }
+    FILE* f = fopen(argv[1], "rb");
+    if (!f) {
+        perror(argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> image;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) image.insert(image.end(), chunk, chunk + n);
+    fclose(f);
+
+    // Целые блоки; стёртые молча пропускаются, испорченные - с сообщением
+    std::vector<BlockRef> blocks;
+    size_t corrupt = 0;
+    for (size_t off = 0; off + LOG_BLOCK_SIZE <= image.size(); off += LOG_BLOCK_SIZE) {
+        LogBlockHeader h;
+        if (logBlockValid(&image[off], h)) {
+            blocks.push_back({h.sequence, static_cast<long>(off)});
+        } else if (h.magic == LOG_BLOCK_MAGIC) {
+            fprintf(stderr, "block at 0x%lx: bad CRC, skipped\n", static_cast<unsigned long>(off));
+            corrupt++;
+        }
+    }
+    if (blocks.empty()) {
+        fprintf(stderr, "no log blocks found\n");
+        return 1;
+    }
+
+    // Кольцо: самый старый блок - сразу за наибольшим разрывом номеров
+    std::sort(blocks.begin(), blocks.end(),
+              [](const BlockRef& a, const BlockRef& b) { return a.sequence < b.sequence; });
+    size_t start = 0;
+    uint32_t widest = 0;
+    for (size_t k = 0; k < blocks.size(); k++) {
+        uint32_t gap = blocks[(k + 1) % blocks.size()].sequence - blocks[k].sequence;
+        if (gap > widest) {
+            widest = gap;
+            start = (k + 1) % blocks.size();
+        }
+    }
+
+    LogBlockHeader first;
+    logBlockValid(&image[blocks[start].offset], first);
+    printf("boot,cycle,time_s");
+    for (int c = 1; c <= first.channels; c++) printf(",t%d,sp%d,duty%d,flags%d", c, c, c, c);
+    printf("\n");
+
+    size_t frames = 0;
+    for (size_t k = 0; k < blocks.size(); k++) {
+        LogDecoder dec(&image[blocks[(start + k) % blocks.size()].offset]);
+        const LogBlockHeader& h = dec.header();
+        if (h.channels != first.channels) {
+            fprintf(stderr, "block %u: %u channels instead of %u, skipped\n", h.sequence, h.channels, first.channels);
+            continue;
+        }
+        LogFrame frame;
+        uint16_t decoded = 0;
+        while (dec.next(frame)) {
+            printf("%u,%u,%u.%03u", h.boot, frame.cycle, frame.timeMs / 1000, frame.timeMs % 1000);
+            for (int c = 0; c < h.channels; c++) {
+                printf(",");
+                printTenths(frame.ch[c].temp);
+                printf(",");
+                printTenths(frame.ch[c].setpoint);
+                printf(",%u,%u", frame.ch[c].duty, frame.ch[c].flags);
+            }
+            printf("\n");
+            decoded++;
+        }
+        if (decoded != h.frames) fprintf(stderr, "block %u: decoded %u of %u frames\n", h.sequence, decoded, h.frames);
+        frames += decoded;
+    }
+    fprintf(stderr, "%zu blocks (%zu corrupt), %zu frames\n", blocks.size(), corrupt, frames);
+    return 0;
+}